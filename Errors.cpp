@@ -1,8 +1,16 @@
 #include <assert.h>
+#include <execinfo.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+
+#include <atomic>
+#include <chrono>
+#include <system_error>
+#include <thread>
 
 #include "Colors.h"
 #include "Errors.h"
@@ -102,4 +110,276 @@ bool HasError()
 Errors GetError()
 {
     return ErrorInfo.error;
-}
\ No newline at end of file
+}
+//-----------------------------------------------------------------------------------------------
+
+#ifndef ERRORS_RATE_LIMIT
+#define ERRORS_RATE_LIMIT 1000
+#endif
+
+static const size_t ErrorsRingCapacity = 64; ///< power of 2
+static const int    ErrorsPollPeriodMs = 10;
+
+struct ErrorRecordType
+{
+    int         code;
+    const char* fileName;
+    const char* funcName;
+    int         line;
+    void*       caller;
+    uint64_t    timeNs;
+
+    bool                hasPayload;
+    ErrorPayloadType    payload;
+    ErrorFormatFuncType format;
+};
+
+/// cell of bounded MPMC ring (D. Vyukov), sequence tells whose turn it is
+struct ErrorsRingCellType
+{
+    std::atomic<size_t> sequence;
+    ErrorRecordType     record;
+};
+
+static ErrorsRingCellType  ErrorsRing[ErrorsRingCapacity];
+static std::atomic<size_t> ErrorsRingInitialized {0};
+static std::atomic<size_t> ErrorsRingTail {0};
+static std::atomic<size_t> ErrorsRingHead {0};
+
+static std::atomic<uint64_t> ErrorsRateWindow  {0};
+static std::atomic<uint64_t> ErrorsRateCount   {0};
+static std::atomic<uint64_t> ErrorsDropped     {0};
+static std::atomic<uint64_t> ErrorsDroppedShown {0};
+
+static std::atomic<int>  ErrorsThreadState {0}; ///< 0 - not started, 1 - starting, 2 - running
+static std::atomic<bool> ErrorsThreadStop  {false};
+static std::thread       ErrorsThread;
+
+static inline uint64_t ErrorsNow();
+static inline void     ErrorsRingInit();
+static inline bool     ErrorsRateAllows(const uint64_t nowNs);
+static        bool     ErrorsRingPush(const ErrorRecordType* record);
+static        bool     ErrorsRingPop (ErrorRecordType* record);
+
+static void ErrorsThreadStart();
+static void ErrorsThreadStopAtExit();
+static void ErrorsThreadFunc();
+static void ErrorRecordLog(const ErrorRecordType* record);
+
+void ErrorRecord(const int code, const char* fileName, const char* funcName, const int line,
+                 void* caller, const ErrorPayloadType* payload, ErrorFormatFuncType format)
+{
+    const uint64_t nowNs = ErrorsNow();
+
+    if (!ErrorsRateAllows(nowNs))
+    {
+        ErrorsDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ErrorsRingInit();
+
+    ErrorRecordType record = {};
+    record.code       = code;
+    record.fileName   = fileName;
+    record.funcName   = funcName;
+    record.line       = line;
+    record.caller     = caller;
+    record.timeNs     = nowNs;
+    record.hasPayload = payload != nullptr;
+    record.format     = format;
+
+    if (payload)
+        record.payload = *payload;
+
+    if (!ErrorsRingPush(&record))
+        ErrorsDropped.fetch_add(1, std::memory_order_relaxed);
+
+    if (ErrorsThreadState.load(std::memory_order_acquire) == 0)
+        ErrorsThreadStart();
+}
+
+void ErrorsFlush()
+{
+    ErrorsRingInit();
+
+    ErrorRecordType record = {};
+    while (ErrorsRingPop(&record))
+        ErrorRecordLog(&record);
+
+    const uint64_t dropped = ErrorsDropped.load(std::memory_order_relaxed);
+
+    //flush is called by error thread and users at once, each drop is reported by one of them
+    uint64_t shown = ErrorsDroppedShown.load(std::memory_order_relaxed);
+
+    while (dropped > shown)
+    {
+        if (!ErrorsDroppedShown.compare_exchange_weak(shown, dropped, std::memory_order_relaxed))
+            continue;
+
+        Log(HTML_RED_HEAD_BEGIN "\n%llu error records were dropped\n" HTML_HEAD_END "\n",
+            (unsigned long long)(dropped - shown));
+        break;
+    }
+}
+
+static inline uint64_t ErrorsNow()
+{
+    //coarse clock is read without syscall and is enough for rate limit
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static inline bool ErrorsRateAllows(const uint64_t nowNs)
+{
+    const uint64_t window = nowNs / 1000000000ull;
+
+    uint64_t currentWindow = ErrorsRateWindow.load(std::memory_order_relaxed);
+
+    if (currentWindow != window &&
+        ErrorsRateWindow.compare_exchange_strong(currentWindow, window,
+                                                 std::memory_order_relaxed))
+        ErrorsRateCount.store(0, std::memory_order_relaxed);
+
+    return ErrorsRateCount.fetch_add(1, std::memory_order_relaxed) < ERRORS_RATE_LIMIT;
+}
+
+static inline void ErrorsRingInit()
+{
+    if (ErrorsRingInitialized.load(std::memory_order_acquire) == 2)
+        return;
+
+    size_t expected = 0;
+    if (ErrorsRingInitialized.compare_exchange_strong(expected, 1, std::memory_order_acquire))
+    {
+        for (size_t i = 0; i < ErrorsRingCapacity; ++i)
+            ErrorsRing[i].sequence.store(i, std::memory_order_relaxed);
+
+        ErrorsRingInitialized.store(2, std::memory_order_release);
+        return;
+    }
+
+    while (ErrorsRingInitialized.load(std::memory_order_acquire) != 2)
+        ;
+}
+
+static bool ErrorsRingPush(const ErrorRecordType* record)
+{
+    assert(record);
+
+    size_t pos = ErrorsRingTail.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        ErrorsRingCellType* cell = &ErrorsRing[pos & (ErrorsRingCapacity - 1)];
+
+        const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+
+        if (sequence == pos)
+        {
+            if (ErrorsRingTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell->record = *record;
+                cell->sequence.store(pos + 1, std::memory_order_release);
+
+                return true;
+            }
+        }
+        else if (sequence < pos)
+            return false;
+        else
+            pos = ErrorsRingTail.load(std::memory_order_relaxed);
+    }
+}
+
+static bool ErrorsRingPop(ErrorRecordType* record)
+{
+    assert(record);
+
+    size_t pos = ErrorsRingHead.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        ErrorsRingCellType* cell = &ErrorsRing[pos & (ErrorsRingCapacity - 1)];
+
+        const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+
+        if (sequence == pos + 1)
+        {
+            if (ErrorsRingHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                *record = cell->record;
+                cell->sequence.store(pos + ErrorsRingCapacity, std::memory_order_release);
+
+                return true;
+            }
+        }
+        else if (sequence < pos + 1)
+            return false;
+        else
+            pos = ErrorsRingHead.load(std::memory_order_relaxed);
+    }
+}
+
+static void ErrorsThreadStart()
+{
+    int expected = 0;
+    if (!ErrorsThreadState.compare_exchange_strong(expected, 1, std::memory_order_acq_rel))
+        return;
+
+    try
+    {
+        ErrorsThread = std::thread(ErrorsThreadFunc);
+    }
+    catch (const std::system_error&)
+    {
+        //records wait in ring for ErrorsFlush
+        ErrorsThreadState.store(0, std::memory_order_release);
+        return;
+    }
+
+    atexit(ErrorsThreadStopAtExit);
+
+    ErrorsThreadState.store(2, std::memory_order_release);
+}
+
+static void ErrorsThreadStopAtExit()
+{
+    ErrorsThreadStop.store(true, std::memory_order_release);
+
+    if (ErrorsThread.joinable())
+        ErrorsThread.join();
+
+    ErrorsFlush();
+}
+
+static void ErrorsThreadFunc()
+{
+    while (!ErrorsThreadStop.load(std::memory_order_acquire))
+    {
+        ErrorsFlush();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(ErrorsPollPeriodMs));
+    }
+}
+
+static void ErrorRecordLog(const ErrorRecordType* record)
+{
+    assert(record);
+
+    //symbolisation mallocs, so it is done here and not at the moment of error
+    char** callerName = backtrace_symbols(&record->caller, 1);
+
+    Log(HTML_RED_HEAD_BEGIN "\n"
+        "Error %d in file: %s, func: %s, line: %d, called from %s, at %llu ns\n"
+        HTML_HEAD_END "\n",
+        record->code, record->fileName, record->funcName, record->line,
+        callerName ? callerName[0] : "unknown", (unsigned long long)record->timeNs);
+
+    free(callerName);
+
+    if (record->format)
+        record->format(record->code, record->hasPayload ? &record->payload : nullptr);
+}
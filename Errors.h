@@ -9,6 +9,8 @@
 #ifndef ERRORS_H
 #define ERRORS_H
 
+#include <stdint.h>
+
 //#define NDEBUG
 
 //-----------------------------------------------------------------------------------------------
@@ -102,4 +104,35 @@ Errors GetError();
 
 //-----------------------------------------------------------------------------------------------
 
+/// \brief Small copy of object state taken at the moment of error.
+struct ErrorPayloadType
+{
+    uint64_t words[6]; ///< meaning is known only to formatter of the record
+};
+
+/// \brief Prints code and payload of deferred error record to log, called by error thread.
+typedef void (*ErrorFormatFuncType)(const int code, const ErrorPayloadType* payload);
+
+/// \brief Cheap error reporting for hot paths.
+/// \details Record is put into lock-free ring and returns at once. Background thread
+///          symbolises caller address and logs record with formatter. Records over
+///          ERRORS_RATE_LIMIT per second and records not fitting into ring are
+///          dropped and only counted.
+/// \param [in]code error code as int
+/// \param [in]caller return address of function with error, symbolised later
+/// \param [in]payload may be nullptr
+/// \param [in]format may be nullptr, then only code is printed
+void ErrorRecord(const int code, const char* fileName, const char* funcName, const int line,
+                 void* caller, const ErrorPayloadType* payload, ErrorFormatFuncType format);
+
+/// \brief ErrorRecord with __FILE__, __func__, __LINE__ and caller of current function
+#define ERROR_RECORD(code, payload, format)                                     \
+    ErrorRecord((int)(code), __FILE__, __func__, __LINE__,                      \
+                __builtin_return_address(0), (payload), (format))
+
+/// \brief Waits until all records are logged, called at exit too
+void ErrorsFlush();
+
+//-----------------------------------------------------------------------------------------------
+
 #endif // ERRORS_H
\ No newline at end of file
@@ -0,0 +1,197 @@
+#ifndef FIXED_LIST_H
+#define FIXED_LIST_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+#include "List.h"
+#include "ListFreeChain.h"
+
+/// \file
+/// \brief Header only list of at most N elements stored inside the object.
+/// \details Layout is the one of ListType: slot 0 is the end sentinel, free slots form
+///          the chain of ListFreeChain.h. Storage never grows, so there is neither
+///          allocation nor growth branch, and full list reports LIST_IS_FULL. Links are
+///          of the smallest unsigned type holding N, all methods are constexpr, so list
+///          can be built at compile time and kept in static storage.
+
+/// @brief Smallest unsigned type holding positions 0..N
+template <size_t N>
+using FixedListIndexType =
+    typename std::conditional<N <= UINT8_MAX  - 1, uint8_t,
+    typename std::conditional<N <= UINT16_MAX - 1, uint16_t,
+    typename std::conditional<N <= UINT32_MAX - 1, uint32_t,
+                                                   uint64_t>::type>::type>::type;
+
+template <typename T, typename IndexType>
+struct FixedListElemType
+{
+    T value;
+
+    IndexType prevPos;
+    IndexType nextPos;
+};
+
+template <typename T, size_t N>
+class FixedList
+{
+    static_assert(N != 0, "Fixed list has to keep at least one element");
+
+  public:
+    using IndexType = FixedListIndexType<N>;
+    using ElemType  = FixedListElemType<T, IndexType>;
+
+    constexpr FixedList() : data_(), freeBlockHead_(0), size_(0)
+    {
+        freeBlockHead_ = ListFreeChainInit(data_, IndexType(1), SlotsCount);
+    }
+
+    constexpr size_t    GetSize()     const { return size_; }
+    constexpr size_t    GetCapacity() const { return N; }
+    constexpr IndexType GetEnd()      const { return 0; }
+    constexpr IndexType GetHead()     const { return data_[0].nextPos; }
+    constexpr IndexType GetTail()     const { return data_[0].prevPos; }
+    constexpr bool      IsFull()      const { return freeBlockHead_ == 0; }
+
+    /// @brief Inserts value before anchorPos, anchor equal to end means pushing back
+    /// @return LIST_IS_FULL if all N slots are taken
+    constexpr ListErrors Insert(const IndexType anchorPos, const T& value,
+                                IndexType* insertedValPos)
+    {
+        assert(insertedValPos);
+        assert(anchorPos < SlotsCount);
+
+        if (freeBlockHead_ == 0)
+            return ListErrors::LIST_IS_FULL;
+
+        const IndexType newValPos  = ListFreeChainPop(data_, &freeBlockHead_);
+        const IndexType prevAnchor = data_[anchorPos].prevPos;
+
+        data_[newValPos].value   = value;
+        data_[newValPos].prevPos = prevAnchor;
+        data_[newValPos].nextPos = anchorPos;
+
+        data_[prevAnchor].nextPos = newValPos;
+        data_[anchorPos ].prevPos = newValPos;
+
+        size_++;
+
+        *insertedValPos = newValPos;
+
+        return ListErrors::NO_ERR;
+    }
+
+    constexpr ListErrors PushBack (const T& value, IndexType* insertedValPos)
+    {
+        return Insert(GetEnd(),  value, insertedValPos);
+    }
+    constexpr ListErrors PushFront(const T& value, IndexType* insertedValPos)
+    {
+        return Insert(GetHead(), value, insertedValPos);
+    }
+
+    constexpr ListErrors Erase(const IndexType pos)
+    {
+        assert(pos != 0 && pos < SlotsCount);
+
+        const IndexType prevPos = data_[pos].prevPos;
+        const IndexType nextPos = data_[pos].nextPos;
+
+        data_[prevPos].nextPos = nextPos;
+        data_[nextPos].prevPos = prevPos;
+
+        ListFreeChainPush(data_, &freeBlockHead_, pos);
+
+        size_--;
+
+        return ListErrors::NO_ERR;
+    }
+
+    constexpr ListErrors GetNextElem(const IndexType pos, IndexType* nextPos) const
+    {
+        assert(nextPos);
+        assert(pos < SlotsCount);
+
+        *nextPos = data_[pos].nextPos;
+
+        return ListErrors::NO_ERR;
+    }
+
+    constexpr ListErrors GetPrevElem(const IndexType pos, IndexType* prevPos) const
+    {
+        assert(prevPos);
+        assert(pos < SlotsCount);
+
+        *prevPos = data_[pos].prevPos;
+
+        return ListErrors::NO_ERR;
+    }
+
+    constexpr ListErrors GetElemValue(const IndexType pos, T* value) const
+    {
+        assert(value);
+        assert(pos < SlotsCount);
+
+        if (pos == 0)
+            return ListErrors::TRYING_TO_GET_NULL_ELEMENT;
+
+        *value = data_[pos].value;
+
+        return ListErrors::NO_ERR;
+    }
+
+    constexpr ListErrors SetElemValue(const IndexType pos, const T& value)
+    {
+        assert(pos < SlotsCount);
+
+        if (pos == 0)
+            return ListErrors::TRYING_TO_CHANGE_NULL_ELEMENT;
+
+        data_[pos].value = value;
+
+        return ListErrors::NO_ERR;
+    }
+
+    /// @brief Checks links of elements and free chain, O(N)
+    constexpr ListErrors Verify() const
+    {
+        size_t elemsCount = 0;
+
+        for (IndexType pos = GetHead(); pos != 0; pos = data_[pos].nextPos)
+        {
+            if (pos >= SlotsCount || data_[data_[pos].nextPos].prevPos != pos ||
+                elemsCount > N)
+                return ListErrors::INVALID_DATA;
+
+            elemsCount++;
+        }
+
+        size_t freeCount = 0;
+
+        for (IndexType pos = freeBlockHead_; pos != 0; pos = data_[pos].nextPos)
+        {
+            if (pos >= SlotsCount || freeCount > N)
+                return ListErrors::INVALID_DATA;
+
+            freeCount++;
+        }
+
+        if (elemsCount != size_ || elemsCount + freeCount != N)
+            return ListErrors::INVALID_DATA;
+
+        return ListErrors::NO_ERR;
+    }
+
+  private:
+    static constexpr IndexType SlotsCount = N + 1;
+
+    ElemType data_[N + 1];
+
+    IndexType freeBlockHead_;
+    IndexType size_;
+};
+
+#endif
@@ -1,23 +1,47 @@
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
 
 #include "Log.h"
+#include "Errors.h"
 #include "List.h"
-#include "string.h"
+#include "ListOrderIndex.h"
+#include "ListValueIndex.h"
+#include "ListBitmap.h"
+#include "ListFreeChain.h"
+#include "ListTrace.h"
+#include "ListJournal.h"
 
 static const size_t MinCapacity    = 16;
 static const int    POISON         = 0xDEAD;
 
-static inline void ListDataInit(ListElemType* list, 
-                                const size_t leftBorder, const size_t rightBorder,
-                                const size_t listCapacity);
+static const size_t SortPhysicalMinSize = 1 << 10;
+static const double SortPhysicalMinNonSequentialShare = 0.25;
+static const size_t SortFragmentationSampleLinks      = 1 << 12;
+static const size_t SortBinsCount       = 64;
+
+static const size_t LocalitySearchWords = 16;
+
+static inline size_t ListDataInit(ListElemType* list, 
+                                  const size_t leftBorder, const size_t rightBorder);
 static void ListElemInit(ListElemType* elem, const int value, 
                                              const size_t prevPos, 
                                              const size_t nextPos);
+static inline void FreeBlocksInit (ListType* list, const size_t leftBorder);
 static inline void DeleteFreeBlock(ListType* list);
+static inline void RemoveFreeBlock(ListType* list, const size_t pos);
 static inline void AddFreeBlock   (ListType* list, const size_t newPos);
+static inline void UnlinkElem     (ListType* list, const size_t pos);
+static inline void LinkElemBefore (ListType* list, const size_t pos, const size_t anchorPos);
 
 static inline ListErrors ListCapacityIncrease(ListType* list);
+
+static inline void        ListErrorPayloadInit(const ListType* list, ErrorPayloadType* payload);
+static        void        ListErrorFormat     (const int code, const ErrorPayloadType* payload);
 static        ListErrors ListRebuild(ListType* list);
+static inline ListErrors ListVerifyHeader(ListType* list);
 
 //-------Graphic dump funcs---------
 
@@ -33,22 +57,38 @@ static        void DotFileCreateMainEdges     (FILE* outDotFile, const ListType*
 static inline void DotFileCreateAuxiliaryInfo (FILE* outDotFile, const ListType* list);
 static        void DotFileCreateFictiousEdges (FILE* outDotFile, const ListType* list);
 
-static inline ListErrors GetPosForNewVal(ListType* list, size_t* pos);
-
-#define LIST_CHECK(list)                    \
-do                                          \
-{                                           \
-    ListErrors listErr = ListVerify(list);  \
-                                            \
-    if (listErr != ListErrors::NO_ERR)      \
-    {                                       \
-        LIST_TEXT_DUMP(list);               \
-        LIST_ERRORS_LOG_ERROR(listErr);     \
-        return listErr;                     \
-    }                                       \
+static inline ListErrors GetPosForNewVal(ListType* list, const size_t anchorPos, size_t* pos);
+static inline size_t     FindFreeNear   (const ListType* list, const size_t targetPos);
+static inline void       NearestFreeInWord(const ListType* list, const size_t word,
+                                           const size_t targetPos,
+                                           size_t* bestPos, size_t* bestDistance);
+
+static        void       ListSortRelink   (ListType* list, ListCmpFuncType cmp);
+static        ListErrors ListSortPhysical (ListType* list, ListCmpFuncType cmp);
+static inline size_t     MergeChains      (ListElemType* data, size_t left, size_t right,
+                                           ListCmpFuncType cmp);
+static inline double     GetNonSequentialShare(const ListType* list);
+
+#define LIST_CHECK(list)                                                    \
+do                                                                          \
+{                                                                           \
+    if ((list)->verifyLevel == ListVerifyLevel::NONE)                       \
+        break;                                                              \
+                                                                            \
+    LIST_STATS_TIMER_BEGIN(verifyBegin);                                    \
+    ListErrors listErr = (list)->verifyLevel == ListVerifyLevel::FULL ?     \
+                         ListVerify(list) : ListVerifyHeader(list);         \
+    LIST_STATS_ADD(list, verifies, 1);                                      \
+    LIST_STATS_ADD_ELAPSED(list, verifyNs,                                  \
+                           verifyBegin);                                    \
+                                                                            \
+    /*ListVerify has recorded error*/                                       \
+    if (listErr != ListErrors::NO_ERR)                                      \
+        return listErr;                                                     \
 } while (0)
 
-ListErrors ListCtor(ListType* list, const size_t listStandardCapacity)
+ListErrors ListCtor(ListType* list, const size_t listStandardCapacity,
+                    const ListAllocatorType* allocator)
 {
     assert(list);
 
@@ -58,18 +98,47 @@ ListErrors ListCtor(ListType* list, const size_t listStandardCapacity)
     
     list->size = 0;
 
-    list->data = (ListElemType*) calloc(capacity, sizeof(*list->data));
+    list->allocator  = allocator ? *allocator : ListStandardAllocator();
+    list->orderIndex = nullptr;
+    list->valueIndex = nullptr;
+    list->trace      = nullptr;
+    list->journal    = nullptr;
+
+    list->data = (ListElemType*) list->allocator.allocFunc(list->allocator.context,
+                                                           capacity * sizeof(*list->data),
+                                                           alignof(ListElemType));
 
     if (list->data == nullptr)
         return ListErrors::MEMORY_ERR;
 
+    list->occupancy = (uint64_t*) list->allocator.allocFunc(list->allocator.context,
+                                        ListBitmapWordsCount(capacity) * sizeof(*list->occupancy),
+                                        alignof(uint64_t));
+
+    if (list->occupancy == nullptr)
+    {
+        list->allocator.freeFunc(list->allocator.context, list->data,
+                                 capacity * sizeof(*list->data));
+        list->data = nullptr;
+
+        return ListErrors::MEMORY_ERR;
+    }
+
+    memset(list->occupancy, 0, ListBitmapWordsCount(capacity) * sizeof(*list->occupancy));
+
     list->capacity = capacity;
 
     ListElemInit(&list->data[0], POISON, 0, 0);
-    ListDataInit(list->data, 1, list->capacity, list->capacity);
     
     list->end            = 0;
-    list->freeBlockHead  = 1;
+    list->freeBlockHead  = ListDataInit(list->data, 1, list->capacity);
+    list->isLinear       = true;
+    list->allocPolicy    = ListAllocPolicy::FREE_HEAD;
+    list->verifyLevel    = ListVerifyLevel::FULL;
+
+#ifdef LIST_STATS
+    memset(&list->stats, 0, sizeof(list->stats));
+#endif
 
     LIST_CHECK(list);
 
@@ -80,60 +149,110 @@ ListErrors ListDtor(ListType* list)
 {
     assert(list);
 
-    list->end = list->freeBlockHead = 0;
-    list->capacity = list->size = 0;
+    ListTraceStop(list);
+    ListJournalStop(list);
+    ListOrderIndexDisable(list);
+    ListValueIndexDisable(list);
 
     if (list->data != nullptr)
-        free(list->data);
+        list->allocator.freeFunc(list->allocator.context, list->data,
+                                 list->capacity * sizeof(*list->data));
+
+    if (list->occupancy != nullptr)
+        list->allocator.freeFunc(list->allocator.context, list->occupancy,
+                                 ListBitmapWordsCount(list->capacity) * sizeof(*list->occupancy));
+
+    list->end = list->freeBlockHead = 0;
+    list->capacity = list->size = 0;
 
-    list->data = nullptr;
+    list->data      = nullptr;
+    list->occupancy = nullptr;
     return ListErrors::NO_ERR;
 }
 
-ListErrors ListCopy(const ListType* source, ListType* target)
+ListErrors ListCopy(const ListType* source, ListType* target,
+                    const ListAllocatorType* allocator)
 {
     assert(source);
     assert(target);
+    assert(source != target);
 
-    target->capacity      = source->capacity;
+    ListErrors error = ListCtor(target, source->capacity,
+                                allocator ? allocator : &source->allocator);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    memcpy(target->data,      source->data,      source->capacity * sizeof(*source->data));
+    memcpy(target->occupancy, source->occupancy,
+           ListBitmapWordsCount(source->capacity) * sizeof(*source->occupancy));
+
+    target->end           = source->end;
     target->freeBlockHead = source->freeBlockHead;
-    target->data          = source->data;
     target->size          = source->size;
+    target->isLinear      = source->isLinear;
+    target->allocPolicy   = source->allocPolicy;
+    target->verifyLevel   = source->verifyLevel;
+
+    //indexes point to storage of source, they are built again for target
+    if ((source->orderIndex && (error = ListOrderIndexEnable(target)) != ListErrors::NO_ERR) ||
+        (source->valueIndex && (error = ListValueIndexEnable(target)) != ListErrors::NO_ERR))
+    {
+        ListDtor(target);
+        return error;
+    }
+
+    LIST_CHECK(target);
     
     return ListErrors::NO_ERR;
 }
 
-#define LOG_ERR(error)            \
-do                                \
-{                                 \
-    LIST_ERRORS_LOG_ERROR(error); \
-    LIST_TEXT_DUMP(list);         \
-    return error;                 \
+#undef LOG_ERR
+
+//dumps are too slow for error bursts, snapshot is logged later by error thread
+#define LOG_ERR(error)                                      \
+do                                                          \
+{                                                           \
+    ErrorPayloadType errorPayload = {};                     \
+    ListErrorPayloadInit(list, &errorPayload);              \
+    ERROR_RECORD((error), &errorPayload, ListErrorFormat);  \
+    return error;                                           \
 } while (0)
 
 ListErrors ListVerify(ListType* list)
 {
     assert(list);
 
-    if (list->data == nullptr)
-        LOG_ERR(ListErrors::DATA_IS_NULLPTR);
-    
-    if (list->capacity < list->size)
-        LOG_ERR(ListErrors::OUT_OF_RANGE);
+    ListErrors error = ListVerifyHeader(list);
 
-    if (list->data[0].value != POISON)
-        LOG_ERR(ListErrors::INVALID_NULLPTR);
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    //-----popcount of occupancy instead of walking the list-----
+
+    const size_t occupiedCount = ListBitmapCount(list->occupancy,
+                                                 ListBitmapWordsCount(list->capacity));
+
+    if (occupiedCount < list->size || ListBitmapTest(list->occupancy, list->end))
+        LOG_ERR(ListErrors::INVALID_DATA);
 
     size_t freeBlockIndex = list->freeBlockHead;
     if (freeBlockIndex == 0)
+    {
+        if (occupiedCount + 1 != list->capacity)
+            LOG_ERR(ListErrors::INVALID_DATA);
+
         return ListErrors::NO_ERR;
+    }
 
     if (list->data[list->freeBlockHead].prevPos != 0)
         LOG_ERR(ListErrors::INVALID_DATA);
 
+    size_t freeBlocksCount = 1;
+
     while (list->data[freeBlockIndex].nextPos != 0)
     {
-        if (list->data[freeBlockIndex].value != POISON)
+        if (ListBitmapTest(list->occupancy, freeBlockIndex))
             LOG_ERR(ListErrors::INVALID_DATA);
 
         if (list->data[freeBlockIndex].nextPos > list->capacity)
@@ -143,8 +262,36 @@ ListErrors ListVerify(ListType* list)
             LOG_ERR(ListErrors::OUT_OF_RANGE);
         
         freeBlockIndex = list->data[freeBlockIndex].nextPos;
+        freeBlocksCount++;
     }
 
+    //every slot but end is either occupied or in free blocks
+    if (ListBitmapTest(list->occupancy, freeBlockIndex) ||
+        occupiedCount + freeBlocksCount + 1 != list->capacity)
+        LOG_ERR(ListErrors::INVALID_DATA);
+
+    return ListErrors::NO_ERR;
+}
+
+static inline ListErrors ListVerifyHeader(ListType* list)
+{
+    assert(list);
+
+    if (list->data == nullptr)
+        LOG_ERR(ListErrors::DATA_IS_NULLPTR);
+    
+    if (list->capacity < list->size)
+        LOG_ERR(ListErrors::OUT_OF_RANGE);
+
+    if (list->data[0].value != POISON)
+        LOG_ERR(ListErrors::INVALID_NULLPTR);
+
+    if (list->occupancy == nullptr)
+        LOG_ERR(ListErrors::DATA_IS_NULLPTR);
+
+    if (list->freeBlockHead >= list->capacity || list->end >= list->capacity)
+        LOG_ERR(ListErrors::OUT_OF_RANGE);
+
     return ListErrors::NO_ERR;
 }
 
@@ -179,14 +326,20 @@ void ListTextDump(const ListType* list, const char* fileName,
     Log("List capacity: %zu\n", list->capacity);
     Log("List size    : %zu\n", list->size);
 
+    if (list->occupancy)
+        Log("Occupied slots: %zu\n", ListBitmapCount(list->occupancy,
+                                                     ListBitmapWordsCount(list->capacity)));
+
     //-----Print all data----
 
     Log("Data[%p]:\n", list->data);
 
     for (size_t i = 0; i < numberOfElementsToPrint && i < list->capacity; ++i)
     {
-        Log("\tElement id: %zu, value: %d, previous position: %zu, next position: %zu\n",
-            i, list->data[i].value, list->data[i].prevPos, list->data[i].nextPos);
+        Log("\tElement id: %zu, value: %d, previous position: %zu, next position: %zu%s\n",
+            i, list->data[i].value, list->data[i].prevPos, list->data[i].nextPos,
+            list->occupancy && i != list->end && !ListBitmapTest(list->occupancy, i) ?
+                                                                        ", free" : "");
     }
 
     Log("\t...\n");
@@ -324,24 +477,38 @@ ListErrors ListInsert(ListType* list, const size_t anchorPos, const int value,
     assert(list);
     assert(insertedValPos);
     assert(anchorPos < list->capacity);
-    assert(anchorPos == list->end || list->data[anchorPos].value   != POISON);
+    assert(anchorPos == list->end || !ListIsElemFree(list, anchorPos));
+
+    LIST_STATS_TIMER_BEGIN(insertBegin);
 
     LIST_CHECK(list);
     
     size_t newValPos = 0;
     ListErrors error = ListErrors::NO_ERR;
-               error = GetPosForNewVal(list, &newValPos);
+
+    if (list->valueIndex)
+    {
+        error = ListValueIndexReserve(list, list->size + 1);
+
+        if (error != ListErrors::NO_ERR)
+            return error;
+    }
+
+               error = GetPosForNewVal(list, anchorPos, &newValPos);
 
     if (error != ListErrors::NO_ERR)
         return error;
 
-    ListElemInit(&list->data[newValPos], 
-                  value, list->data[anchorPos].prevPos, anchorPos);
+    list->data[newValPos].value = value;
+    LinkElemBefore(list, newValPos, anchorPos);
 
-    const size_t prevAnchor = list->data[anchorPos].prevPos;
+    if (list->orderIndex)
+        ListOrderIndexOnInsert(list, newValPos, anchorPos);
+    if (list->valueIndex)
+        ListValueIndexOnInsert(list, newValPos);
 
-    list->data[prevAnchor].nextPos = newValPos;
-    list->data[anchorPos].prevPos  = newValPos;
+    //appending to slot right after tail is the only insert keeping layout linear
+    list->isLinear = list->isLinear && anchorPos == list->end && newValPos == list->size + 1;
 
     list->size++;
 
@@ -349,6 +516,14 @@ ListErrors ListInsert(ListType* list, const size_t anchorPos, const int value,
 
     *insertedValPos  = newValPos;
 
+    if (list->trace)
+        ListTraceRecord(list, ListTraceOp::INSERT, newValPos, anchorPos, value);
+    if (list->journal)
+        ListJournalRecord(list, ListJournalOp::INSERT, newValPos, anchorPos, value);
+
+    LIST_STATS_ADD   (list, inserts, 1);
+    LIST_STATS_RECORD(list, insertNs, insertBegin);
+
     return ListErrors::NO_ERR;
 }
 
@@ -357,17 +532,115 @@ ListErrors ListErase (ListType* list, const size_t anchorPos)
     assert(list);
     assert(anchorPos < list->capacity);
 
+    LIST_STATS_TIMER_BEGIN(eraseBegin);
+
     LIST_CHECK(list);
 
-    list->data[list->data[anchorPos].prevPos].nextPos = list->data[anchorPos].nextPos;
-    list->data[list->data[anchorPos].nextPos].prevPos = list->data[anchorPos].prevPos;
+    if (list->orderIndex)
+        ListOrderIndexOnErase(list, anchorPos);
+    if (list->valueIndex)
+        ListValueIndexOnErase(list, anchorPos);
 
+    UnlinkElem(list, anchorPos);
     AddFreeBlock(list, anchorPos);
 
+    list->isLinear = list->isLinear && anchorPos == list->size;
+    list->size--;
+
+    LIST_CHECK(list);
+
+    if (list->trace)
+        ListTraceRecord(list, ListTraceOp::ERASE, anchorPos);
+    if (list->journal)
+        ListJournalRecord(list, ListJournalOp::ERASE, anchorPos);
+
+    LIST_STATS_ADD   (list, erases, 1);
+    LIST_STATS_RECORD(list, eraseNs, eraseBegin);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListDetach(ListType* list, const size_t anchorPos)
+{
+    assert(list);
+    assert(anchorPos != list->end && anchorPos < list->capacity);
+
+    LIST_STATS_TIMER_BEGIN(eraseBegin);
+
+    LIST_CHECK(list);
+
+    if (list->orderIndex)
+        ListOrderIndexOnErase(list, anchorPos);
+    if (list->valueIndex)
+        ListValueIndexOnErase(list, anchorPos);
+
+    UnlinkElem(list, anchorPos);
+
+    list->isLinear = list->isLinear && anchorPos == list->size;
     list->size--;
 
     LIST_CHECK(list);
 
+    if (list->trace)
+        ListTraceRecord(list, ListTraceOp::DETACH, anchorPos);
+    if (list->journal)
+        ListJournalRecord(list, ListJournalOp::DETACH, anchorPos);
+
+    LIST_STATS_ADD   (list, erases, 1);
+    LIST_STATS_RECORD(list, eraseNs, eraseBegin);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListReleaseSlot(ListType* list, const size_t pos)
+{
+    assert(list);
+    assert(pos != list->end && pos < list->capacity);
+
+    LIST_CHECK(list);
+
+    AddFreeBlock(list, pos);
+
+    LIST_CHECK(list);
+
+    if (list->trace)
+        ListTraceRecord(list, ListTraceOp::RELEASE, pos);
+    if (list->journal)
+        ListJournalRecord(list, ListJournalOp::RELEASE, pos);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListMoveBefore(ListType* list, const size_t pos, const size_t anchorPos)
+{
+    assert(list);
+    assert(pos != list->end && pos < list->capacity);
+    assert(anchorPos < list->capacity);
+    assert(!ListIsElemFree(list, pos));
+
+    LIST_CHECK(list);
+
+    if (pos == anchorPos || list->data[pos].nextPos == anchorPos)
+        return ListErrors::NO_ERR;
+
+    if (list->orderIndex)
+        ListOrderIndexOnErase(list, pos);
+
+    UnlinkElem    (list, pos);
+    LinkElemBefore(list, pos, anchorPos);
+
+    if (list->orderIndex)
+        ListOrderIndexOnInsert(list, pos, anchorPos);
+
+    list->isLinear = false;
+
+    LIST_CHECK(list);
+
+    if (list->trace)
+        ListTraceRecord(list, ListTraceOp::MOVE, pos, anchorPos);
+    if (list->journal)
+        ListJournalRecord(list, ListJournalOp::MOVE, pos, anchorPos);
+
     return ListErrors::NO_ERR;
 }
 
@@ -407,10 +680,13 @@ ListErrors ListGetElemValue(ListType* list, size_t pos, int* elemValue)
 
     *elemValue = list->data[pos].value;
 
+    if (list->trace)
+        ListTraceRecord(list, ListTraceOp::GET, pos);
+
     return ListErrors::NO_ERR;
 }
 
-ListErrors ListSetElem(ListType* list, size_t pos, int  newElemValue)
+ListErrors ListSetElemValue(ListType* list, size_t pos, int  newElemValue)
 {
     assert(list);
 
@@ -419,27 +695,37 @@ ListErrors ListSetElem(ListType* list, size_t pos, int  newElemValue)
 
     LIST_CHECK(list);
 
-    list->data[pos].value = newElemValue;
+    if (list->valueIndex)
+        ListValueIndexOnErase(list, pos);
+
+    __atomic_store_n(&list->data[pos].value, newElemValue, __ATOMIC_RELAXED);
+
+    if (list->valueIndex)
+        ListValueIndexOnInsert(list, pos);
 
     LIST_CHECK(list);
 
+    if (list->trace)
+        ListTraceRecord(list, ListTraceOp::SET, pos, 0, newElemValue);
+    if (list->journal)
+        ListJournalRecord(list, ListJournalOp::SET, pos, 0, newElemValue);
+
     return ListErrors::NO_ERR;
 }
 
-static inline void ListDataInit(ListElemType* list, 
-                                const size_t leftBorder, const size_t rightBorder,
-                                const size_t listCapacity)
+/// @brief Poisons slots of [leftBorder, rightBorder) and chains them as free blocks
+/// @return head of chain
+static inline size_t ListDataInit(ListElemType* list, 
+                                  const size_t leftBorder, const size_t rightBorder)
 {
     assert(list);
-    assert(leftBorder  <= rightBorder);
-    assert(rightBorder <= listCapacity);
+    assert(leftBorder <= rightBorder);
     assert(leftBorder != 0);
 
     for (size_t i = leftBorder; i < rightBorder; ++i)
-        ListElemInit(&list[i], POISON, i - 1, i + 1);
+        list[i].value = POISON;
 
-    if (rightBorder == listCapacity)
-        ListElemInit(&list[listCapacity - 1], POISON, listCapacity - 2, 0);  
+    return ListFreeChainInit(list, leftBorder, rightBorder);
 }
 
 void ListElemInit(ListElemType* elem, const int value, 
@@ -464,29 +750,95 @@ void ListErrorsLogError(ListErrors error, const char* fileName,
         "Logging errors called from file: %s, func: %s, line: %d"
         HTML_HEAD_END, fileName, funcName, line);
 
+    Log("%s", ListErrorsGetMessage(error));
+}
+
+const char* ListErrorsGetMessage(const ListErrors error)
+{
     switch(error)
     {
         case ListErrors::DATA_IS_NULLPTR:
-            Log("Data is nullptr\n");
-            break;
+            return "Data is nullptr\n";
         case ListErrors::INVALID_DATA:
-            Log("Invalid data\n");
-            break;
+            return "Invalid data\n";
         case ListErrors::INVALID_NULLPTR:
-            Log("Null adress in list is invalid\n");
-            break;
+            return "Null adress in list is invalid\n";
         case ListErrors::MEMORY_ERR:
-            Log("Memory error\n");
-            break;
+            return "Memory error\n";
         case ListErrors::OUT_OF_RANGE:
-            Log("List element is out of range\n");
-            break;
+            return "List element is out of range\n";
+        case ListErrors::QUEUE_IS_FULL:
+            return "Queue is full\n";
+        case ListErrors::QUEUE_IS_EMPTY:
+            return "Queue is empty\n";
+
+        case ListErrors::VALUE_NOT_FOUND:
+            return "Value is not found\n";
+        case ListErrors::LIST_IS_FULL:
+            return "Fixed capacity list is full\n";
+        case ListErrors::FILE_ERR:
+            return "File can not be opened or written\n";
         
+        case ListErrors::TRYING_TO_GET_NULL_ELEMENT:
+            return "Trying to get null element\n";
+        case ListErrors::TRYING_TO_CHANGE_NULL_ELEMENT:
+            return "Trying to change null element\n";
+
         case ListErrors::NO_ERR:
         default:
-            break;
+            return "";
     }
-}                                          
+}
+
+static inline void ListErrorPayloadInit(const ListType* list, ErrorPayloadType* payload)
+{
+    assert(list);
+    assert(payload);
+
+    //only list fields are copied, data may be broken
+    payload->words[0] = (uint64_t)list->data;
+    payload->words[1] = list->end;
+    payload->words[2] = list->freeBlockHead;
+    payload->words[3] = list->size;
+    payload->words[4] = list->capacity;
+    payload->words[5] = list->isLinear;
+}
+
+static void ListErrorFormat(const int code, const ErrorPayloadType* payload)
+{
+    Log("%s", ListErrorsGetMessage((ListErrors)code));
+
+    if (payload == nullptr)
+        return;
+
+    Log("List data: %p, end: %llu, free blocks head: %llu, size: %llu, capacity: %llu, "
+        "linear: %llu\n", (void*)payload->words[0],
+        (unsigned long long)payload->words[1], (unsigned long long)payload->words[2],
+        (unsigned long long)payload->words[3], (unsigned long long)payload->words[4],
+        (unsigned long long)payload->words[5]);
+}
+
+static inline void FreeBlocksInit(ListType* list, const size_t leftBorder)
+{
+    assert(list);
+    assert(leftBorder != 0);
+
+    //used by linear layouts only: slots before leftBorder hold elements
+    ListBitmapClear(list->occupancy, 0);
+    ListBitmapAssignRange(list->occupancy, 1, leftBorder < list->capacity ? leftBorder
+                                                                          : list->capacity,
+                          true);
+
+    if (leftBorder >= list->capacity)
+    {
+        list->freeBlockHead = 0;
+        return;
+    }
+
+    ListBitmapAssignRange(list->occupancy, leftBorder, list->capacity, false);
+
+    list->freeBlockHead = ListDataInit(list->data, leftBorder, list->capacity);
+}
 
 static inline void DeleteFreeBlock(ListType* list)
 {
@@ -497,11 +849,24 @@ static inline void DeleteFreeBlock(ListType* list)
 
     assert(list->freeBlockHead != 0);
 
-    list->data[list->freeBlockHead].value = POISON;
-               list->freeBlockHead        = list->data[list->freeBlockHead].nextPos;
+    const size_t pos = ListFreeChainPop(list->data, &list->freeBlockHead);
+
+    ListBitmapSet(list->occupancy, pos);
+    list->data[pos].value = POISON;
+}
+
+static inline void RemoveFreeBlock(ListType* list, const size_t pos)
+{
+    assert(list);
+    assert(pos != list->end && pos < list->capacity);
+    assert(!ListBitmapTest(list->occupancy, pos));
+
+    //free blocks are doubly linked, any of them is unlinked in O(1)
+    ListFreeChainRemove(list->data, &list->freeBlockHead, pos);
+
+    ListBitmapSet(list->occupancy, pos);
 
-    if (list->freeBlockHead != 0)
-        list->data[list->freeBlockHead].prevPos = 0;
+    list->data[pos].value = POISON;
 }
 
 static inline void AddFreeBlock(ListType* list, const size_t newPos)
@@ -509,37 +874,86 @@ static inline void AddFreeBlock(ListType* list, const size_t newPos)
     assert(list);
     assert(newPos < list->capacity);
 
-    if (list->freeBlockHead == 0)
-    {
-        list->freeBlockHead = newPos;
-        ListElemInit(&list->data[list->freeBlockHead], POISON, 0, 0);
+    ListBitmapClear(list->occupancy, newPos);
 
-        return;
-    }
+    list->data[newPos].value = POISON;
+    ListFreeChainPush(list->data, &list->freeBlockHead, newPos);
+}
+
+static inline void UnlinkElem(ListType* list, const size_t pos)
+{
+    assert(list);
+    assert(pos < list->capacity);
+
+    const size_t prevPos = list->data[pos].prevPos;
+    const size_t nextPos = list->data[pos].nextPos;
+
+    //element keeps its own links, so readers standing on it can still move on
+    __atomic_store_n(&list->data[prevPos].nextPos, nextPos, __ATOMIC_RELEASE);
+    __atomic_store_n(&list->data[nextPos].prevPos, prevPos, __ATOMIC_RELEASE);
+}
+
+static inline void LinkElemBefore(ListType* list, const size_t pos, const size_t anchorPos)
+{
+    assert(list);
+    assert(pos       < list->capacity);
+    assert(anchorPos < list->capacity);
+
+    const size_t prevAnchor = list->data[anchorPos].prevPos;
+
+    list->data[pos].prevPos = prevAnchor;
+    list->data[pos].nextPos = anchorPos;
 
-    //do not change order!
-    list->data[list->freeBlockHead].prevPos = newPos;
-    ListElemInit(&list->data[newPos], POISON, 0, list->freeBlockHead);
-    list->freeBlockHead = newPos;
+    //release: concurrent readers following links see initialized element
+    __atomic_store_n(&list->data[prevAnchor].nextPos, pos, __ATOMIC_RELEASE);
+    __atomic_store_n(&list->data[anchorPos].prevPos,  pos, __ATOMIC_RELEASE);
 }
 
 static inline ListErrors ListCapacityIncrease(ListType* list)
 {
     assert(list);
+    assert(list->freeBlockHead == 0);
+
+    if (list->orderIndex)
+    {
+        ListErrors error = ListOrderIndexReserve(list, list->capacity * 2);
+
+        if (error != ListErrors::NO_ERR)
+            return error;
+    }
     
-    if (list->freeBlockHead == 0)
-        list->freeBlockHead = list->capacity;
+    const size_t wordsCount    = ListBitmapWordsCount(list->capacity);
+    const size_t newWordsCount = ListBitmapWordsCount(list->capacity * 2);
 
-    list->capacity *= 2;
+    void* tmpPtr = list->allocator.reallocFunc(list->allocator.context, list->occupancy,
+                                               wordsCount    * sizeof(*list->occupancy),
+                                               newWordsCount * sizeof(*list->occupancy),
+                                               alignof(uint64_t));
 
-    void* tmpPtr = realloc(list->data, list->capacity * sizeof(*list->data));
+    if (tmpPtr == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    list->occupancy = (uint64_t*)tmpPtr;
+    memset(list->occupancy + wordsCount, 0,
+           (newWordsCount - wordsCount) * sizeof(*list->occupancy));
+    
+    tmpPtr = list->allocator.reallocFunc(list->allocator.context, list->data, 
+                                         list->capacity     * sizeof(*list->data),
+                                         list->capacity * 2 * sizeof(*list->data),
+                                         alignof(ListElemType));
 
     if (tmpPtr == nullptr)
         return ListErrors::MEMORY_ERR;
     
     list->data = (ListElemType*)tmpPtr;
+
+    LIST_STATS_ADD(list, capacityIncreases, 1);
+    LIST_STATS_ADD(list, bytesReallocated, list->capacity * 2 * sizeof(*list->data) +
+                                           newWordsCount * sizeof(*list->occupancy));
+
+    list->capacity *= 2;
     
-    ListDataInit(list->data, list->capacity / 2, list->capacity, list->capacity);
+    list->freeBlockHead = ListDataInit(list->data, list->capacity / 2, list->capacity);
 
     return ListErrors::NO_ERR;
 }
@@ -548,32 +962,75 @@ static ListErrors ListRebuild(ListType* list)
 {
     assert(list);
 
-    ListType newList = {};
-    ListCtor(&newList, list->capacity); 
+    ListElemType* newData = (ListElemType*) list->allocator.allocFunc(list->allocator.context,
+                                                list->capacity * sizeof(*newData),
+                                                alignof(ListElemType));
+
+    if (newData == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    LIST_STATS_ADD(list, rebuilds, 1);
 
     //-----rebuild used values-------
 
-    size_t posInNewList = 1;
+    size_t posInNewList = 0;
 
-    size_t listTail = ListGetTail(list);
-    for (size_t i = ListGetHead(list); i != listTail; i = list->data[i].nextPos)
+    for (size_t i = ListGetHead(list); i != list->end; i = list->data[i].nextPos)
     {
-        ListElemInit(&newList.data[posInNewList], list->data[i].value, 
-                                                  posInNewList - 1, posInNewList + 1);
         ++posInNewList;
+        ListElemInit(&newData[posInNewList], list->data[i].value, 
+                                             posInNewList - 1, posInNewList + 1);
     }
-    ListElemInit(newList.data + posInNewList, list->data[listTail].value,
-                                              posInNewList - 1, 0);
-    ListElemInit(newList.data, POISON, posInNewList, 1);
 
-    newList.end  = 0;
-    newList.freeBlockHead = (posInNewList + 1) % list->capacity;
-    newList.size = list->size;
+    if (posInNewList != 0)
+        newData[posInNewList].nextPos = 0;
+
+    ListElemInit(newData, POISON, posInNewList, posInNewList == 0 ? 0 : 1);
+
+    list->allocator.freeFunc(list->allocator.context, list->data,
+                             list->capacity * sizeof(*list->data));
 
-    ListDtor(list);
-    *list = newList;
+    //list fields are kept, so indexes attached to list stay with it
+    list->data     = newData;
+    list->end      = 0;
+    list->isLinear = true;
+
+    FreeBlocksInit(list, posInNewList + 1);
+
+    return ListIndexesRebuild(list);
+}
+
+ListErrors ListIndexesRebuild(ListType* list)
+{
+    assert(list);
+
+    ListErrors error = ListErrors::NO_ERR;
+
+    if (list->orderIndex && (error = ListOrderIndexRebuild(list)) != ListErrors::NO_ERR)
+        return error;
+
+    if (list->valueIndex && (error = ListValueIndexRebuild(list)) != ListErrors::NO_ERR)
+        return error;
+
+    //trace positions are valid again only after new snapshot
+    if (list->trace)
+        ListTraceSnapshot(list);
+
+    //moves are not journaled, journal starts again from new snapshot
+    if (list->journal && (error = ListJournalCheckpoint(list)) != ListErrors::NO_ERR)
+        return error;
+
+    LIST_CHECK(list);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListVerifyByLevel(ListType* list)
+{
+    assert(list);
+
+    LIST_CHECK(list);
 
-    //NO newList Dtor because there is calloced memory used for list and nothing more dynamic
     return ListErrors::NO_ERR;
 }
 
@@ -581,21 +1038,221 @@ ListErrors ListCapacityDecrease(ListType* list)
 {
     assert(list);
 
-    ListRebuild(list);
-    assert(ListGetTail(list) * 2 < list->capacity);
+    ListErrors error = ListRebuild(list);
 
-    list->capacity /= 2;
+    if (error != ListErrors::NO_ERR)
+        return error;
 
-    void* tmpPtr = realloc(list->data, list->capacity * sizeof(*list->data));
+    assert(ListGetTail(list) * 2 < list->capacity);
+
+    void* tmpPtr = list->allocator.reallocFunc(list->allocator.context, list->data, 
+                                               list->capacity     * sizeof(*list->data),
+                                               list->capacity / 2 * sizeof(*list->data),
+                                               alignof(ListElemType));
 
     if (tmpPtr == nullptr)
         return ListErrors::MEMORY_ERR;
     
     list->data = (ListElemType*)tmpPtr;
 
+    //on failure old bigger bitmap is kept, it stays valid for smaller capacity
+    tmpPtr = list->allocator.reallocFunc(list->allocator.context, list->occupancy,
+                        ListBitmapWordsCount(list->capacity)     * sizeof(*list->occupancy),
+                        ListBitmapWordsCount(list->capacity / 2) * sizeof(*list->occupancy),
+                        alignof(uint64_t));
+
+    if (tmpPtr != nullptr)
+        list->occupancy = (uint64_t*)tmpPtr;
+
+    list->capacity /= 2;
+
+    LIST_STATS_ADD(list, capacityDecreases, 1);
+    LIST_STATS_ADD(list, bytesReallocated, list->capacity * sizeof(*list->data));
+
+    FreeBlocksInit(list, list->size + 1);
+
+    //snapshot made by rebuild has old capacity, so it is taken again
+    if (list->journal)
+        return ListJournalCheckpoint(list);
+
     return ListErrors::NO_ERR;
 }
 
+ListErrors ListSort(ListType* list, ListCmpFuncType cmp, const ListSortStrategy strategy)
+{
+    assert(list);
+    assert(cmp);
+    assert(list->end == 0);
+
+    LIST_CHECK(list);
+
+    bool isPhysical = false;
+    switch (strategy)
+    {
+        case ListSortStrategy::RELINK:
+            isPhysical = false;
+            break;
+        case ListSortStrategy::PHYSICAL:
+            isPhysical = true;
+            break;
+        
+        case ListSortStrategy::AUTO:
+        default:
+            //pointer chasing merges lose to array sort on big lists, relayout is worth
+            //it if list fills most of capacity or links jump around memory anyway
+            isPhysical = list->size >= SortPhysicalMinSize &&
+                         (list->size * 2 >= list->capacity ||
+                          GetNonSequentialShare(list) >= SortPhysicalMinNonSequentialShare);
+            break;
+    }
+
+    //relinking needs no memory, so it is fallback for physical sort too
+    if (!isPhysical || ListSortPhysical(list, cmp) != ListErrors::NO_ERR)
+        ListSortRelink(list, cmp);
+
+    return ListIndexesRebuild(list);
+}
+
+static void ListSortRelink(ListType* list, ListCmpFuncType cmp)
+{
+    assert(list);
+    assert(cmp);
+
+    //bin i keeps sorted chain of 2^i elements, chains are terminated by end (0)
+    size_t bins[SortBinsCount] = {};
+
+    size_t pos = ListGetHead(list);
+    while (pos != list->end)
+    {
+        const size_t nextPos = list->data[pos].nextPos;
+        list->data[pos].nextPos = list->end;
+
+        size_t carry = pos;
+        size_t binIndex = 0;
+        for (; binIndex < SortBinsCount - 1 && bins[binIndex] != list->end; ++binIndex)
+        {
+            //elements in bins are earlier in list, they go left for stability
+            carry = MergeChains(list->data, bins[binIndex], carry, cmp);
+            bins[binIndex] = list->end;
+        }
+
+        bins[binIndex] = carry;
+
+        pos = nextPos;
+    }
+
+    size_t sorted = list->end;
+    for (size_t i = 0; i < SortBinsCount; ++i)
+    {
+        if (bins[i] != list->end)
+            sorted = MergeChains(list->data, bins[i], sorted, cmp);
+    }
+
+    //-----restoring previous positions-----
+
+    size_t prevPos = list->end;
+    for (pos = sorted; pos != list->end; pos = list->data[pos].nextPos)
+    {
+        list->data[pos].prevPos = prevPos;
+        prevPos = pos;
+    }
+
+    list->data[list->end].nextPos = sorted;
+    list->data[list->end].prevPos = prevPos;
+
+    //positions keep their values, so order of slots is lost
+    list->isLinear = list->isLinear && list->size <= 1;
+}
+
+static inline size_t MergeChains(ListElemType* data, size_t left, size_t right,
+                                 ListCmpFuncType cmp)
+{
+    assert(data);
+    assert(cmp);
+
+    size_t  head = 0;
+    size_t* link = &head;
+
+    while (left != 0 && right != 0)
+    {
+        if (cmp(data[right].value, data[left].value) < 0)
+        {
+            *link = right;
+            link  = &data[right].nextPos;
+            right = data[right].nextPos;
+        }
+        else
+        {
+            *link = left;
+            link  = &data[left].nextPos;
+            left  = data[left].nextPos;
+        }
+    }
+
+    *link = left != 0 ? left : right;
+
+    return head;
+}
+
+static ListErrors ListSortPhysical(ListType* list, ListCmpFuncType cmp)
+{
+    assert(list);
+    assert(cmp);
+
+    const size_t size = list->size;
+
+    int* values = (int*) list->allocator.allocFunc(list->allocator.context,
+                                                   size * sizeof(*values), alignof(int));
+
+    if (values == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    size_t valueIndex = 0;
+    for (size_t pos = ListGetHead(list); pos != list->end; pos = list->data[pos].nextPos)
+        values[valueIndex++] = list->data[pos].value;
+
+    assert(valueIndex == size);
+
+    std::stable_sort(values, values + size, 
+                     [cmp](const int a, const int b) { return cmp(a, b) < 0; });
+
+    //-----linear layout: element i at slot i + 1, free blocks after them-----
+
+    for (size_t i = 0; i < size; ++i)
+        ListElemInit(&list->data[i + 1], values[i], i, i + 1 == size ? 0 : i + 2);
+
+    list->allocator.freeFunc(list->allocator.context, values, size * sizeof(*values));
+
+    ListElemInit(&list->data[0], POISON, size, size == 0 ? 0 : 1);
+
+    FreeBlocksInit(list, size + 1);
+    list->isLinear = true;
+
+    return ListErrors::NO_ERR;
+}
+
+/// @brief Share of links not going to the next slot among first links of list
+/// @details Walking whole scattered list costs about half of sort itself, prefix is enough.
+static inline double GetNonSequentialShare(const ListType* list)
+{
+    assert(list);
+
+    if (list->isLinear || list->size <= 1)
+        return 0;
+
+    size_t linksCount         = 0;
+    size_t nonSequentialCount = 0;
+
+    for (size_t pos = ListGetHead(list); list->data[pos].nextPos != list->end &&
+                linksCount < SortFragmentationSampleLinks; pos = list->data[pos].nextPos)
+    {
+        linksCount++;
+        nonSequentialCount += list->data[pos].nextPos != pos + 1;
+    }
+
+    return (double)nonSequentialCount / (double)linksCount;
+}
+
 size_t ListGetHead(const ListType* list)
 {
     assert(list);
@@ -610,7 +1267,61 @@ size_t ListGetTail(const ListType* list)
     return list->data[list->end].prevPos;
 }
 
-static inline ListErrors GetPosForNewVal(ListType* list, size_t* pos)
+bool ListIsElemFree(const ListType* list, const size_t pos)
+{
+    assert(list);
+    assert(pos < list->capacity);
+
+    return pos != list->end && !ListBitmapTest(list->occupancy, pos);
+}
+
+void ListSetAllocPolicy(ListType* list, const ListAllocPolicy policy)
+{
+    assert(list);
+
+    list->allocPolicy = policy;
+
+    if (list->journal)
+        ListJournalRecord(list, ListJournalOp::POLICY, 0, 0, (int)policy);
+}
+
+void ListSetVerifyLevel(ListType* list, const ListVerifyLevel level)
+{
+    assert(list);
+
+    list->verifyLevel = level;
+}
+
+ListErrors ListGetFragmentation(ListType* list, ListFragmentationType* fragmentation)
+{
+    assert(list);
+    assert(fragmentation);
+
+    LIST_CHECK(list);
+
+    size_t linksCount         = 0;
+    size_t nonSequentialCount = 0;
+    double distanceSum        = 0;
+
+    for (size_t pos = ListGetHead(list); pos != list->end; pos = list->data[pos].nextPos)
+    {
+        const size_t nextPos = list->data[pos].nextPos;
+        if (nextPos == list->end)
+            break;
+
+        linksCount++;
+        nonSequentialCount += nextPos != pos + 1;
+        distanceSum        += (double)(nextPos > pos ? nextPos - pos : pos - nextPos);
+    }
+
+    fragmentation->nonSequentialLinks = linksCount == 0 ? 0 : 
+                                        (double)nonSequentialCount / (double)linksCount;
+    fragmentation->meanLinkDistance   = linksCount == 0 ? 0 : distanceSum / (double)linksCount;
+
+    return ListErrors::NO_ERR;
+}
+
+static inline ListErrors GetPosForNewVal(ListType* list, const size_t anchorPos, size_t* pos)
 {
     assert(list);
     assert(pos);
@@ -621,9 +1332,90 @@ static inline ListErrors GetPosForNewVal(ListType* list, size_t* pos)
 
     if (error != ListErrors::NO_ERR)
         return error;
+
+    if (list->allocPolicy == ListAllocPolicy::NEAR_ANCHOR)
+    {
+        //new element goes between anchor and its previous one, both are good neighbours
+        size_t targetPos = anchorPos != list->end ? anchorPos : list->data[anchorPos].prevPos;
+
+        const size_t nearPos = targetPos != list->end ? FindFreeNear(list, targetPos) : 0;
+
+        if (nearPos != 0)
+        {
+            RemoveFreeBlock(list, nearPos);
+            LIST_STATS_ADD(list, nearAnchorAllocs, 1);
+
+            *pos = nearPos;
+            return ListErrors::NO_ERR;
+        }
+    }
     
     *pos = list->freeBlockHead;
     DeleteFreeBlock(list);
+    LIST_STATS_ADD(list, freeHeadAllocs, 1);
 
     return ListErrors::NO_ERR;
 }
+
+static inline size_t FindFreeNear(const ListType* list, const size_t targetPos)
+{
+    assert(list);
+    assert(targetPos < list->capacity);
+
+    const size_t wordsCount = ListBitmapWordsCount(list->capacity);
+    const size_t targetWord = targetPos / ListBitmapWordBits;
+
+    size_t bestPos      = 0;
+    size_t bestDistance = SIZE_MAX;
+
+    //words are looked at in rings around target until no closer slot is possible,
+    //far free slot is no better than free head
+    for (size_t ring = 0; ring <= LocalitySearchWords; ++ring)
+    {
+        const size_t ringDistance = ring == 0 ? 0 : (ring - 1) * ListBitmapWordBits + 1;
+        if (ringDistance > bestDistance)
+            break;
+
+        if (targetWord + ring < wordsCount)
+            NearestFreeInWord(list, targetWord + ring, targetPos, &bestPos, &bestDistance);
+
+        if (ring != 0 && ring <= targetWord)
+            NearestFreeInWord(list, targetWord - ring, targetPos, &bestPos, &bestDistance);
+    }
+
+    return bestPos;
+}
+
+static inline void NearestFreeInWord(const ListType* list, const size_t word,
+                                     const size_t targetPos,
+                                     size_t* bestPos, size_t* bestDistance)
+{
+    assert(list);
+    assert(bestPos);
+    assert(bestDistance);
+
+    const size_t wordBits = ListBitmapWordBits;
+
+    uint64_t freeBits = ~list->occupancy[word];
+
+    if (word == list->end / wordBits)
+        freeBits &= ~((uint64_t)1 << (list->end % wordBits));
+
+    if (word == list->capacity / wordBits)
+        freeBits &= ((uint64_t)1 << (list->capacity % wordBits)) - 1;
+
+    while (freeBits != 0)
+    {
+        const size_t pos = word * wordBits + (size_t)__builtin_ctzll(freeBits);
+        freeBits &= freeBits - 1;
+
+        const size_t distance = pos > targetPos ? pos - targetPos : targetPos - pos;
+
+        //on tie slot after target wins, lists are mostly walked forward
+        if (distance < *bestDistance || (distance == *bestDistance && pos > targetPos))
+        {
+            *bestPos      = pos;
+            *bestDistance = distance;
+        }
+    }
+}
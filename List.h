@@ -4,6 +4,9 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "ListAllocator.h"
+#include "ListStats.h"
+
 struct ListElemType
 {
     int value;
@@ -12,15 +15,50 @@ struct ListElemType
     size_t nextPos;
 };
 
+enum class ListAllocPolicy
+{
+    FREE_HEAD,      ///< slot from head of free blocks, last freed slot is reused first
+    NEAR_ANCHOR,    ///< free slot physically nearest to insertion place, free head if none
+};
+
+enum class ListVerifyLevel
+{
+    NONE,   ///< operations do not check list
+    HEADER, ///< O(1) checks of fields and sentinel
+    FULL,   ///< O(capacity) check of occupancy and free blocks, default
+};
+
+struct ListOrderIndexType;
+struct ListValueIndexType;
+struct ListTraceType;
+struct ListJournalType;
+
 struct ListType
 {
     ListElemType* data;
+    uint64_t*     occupancy; ///< bit per slot, set if slot holds element
 
     size_t end;
     size_t freeBlockHead;
 
     size_t size;
     size_t capacity;
+
+    ListAllocatorType allocator;
+
+    bool isLinear; ///< elements are in slots 1..size in list order
+
+    ListAllocPolicy allocPolicy;
+    ListVerifyLevel verifyLevel; ///< check made before and after every operation
+
+#ifdef LIST_STATS
+    ListStatsType stats;
+#endif
+
+    ListOrderIndexType* orderIndex; ///< optional, nullptr if disabled
+    ListValueIndexType* valueIndex; ///< optional, nullptr if disabled
+    ListTraceType*      trace;      ///< optional recorder, nullptr if disabled
+    ListJournalType*    journal;    ///< optional write-ahead journal, nullptr if disabled
 };
 
 enum class ListErrors
@@ -37,18 +75,72 @@ enum class ListErrors
 
     TRYING_TO_GET_NULL_ELEMENT,
     TRYING_TO_CHANGE_NULL_ELEMENT,
+
+    QUEUE_IS_FULL,
+    QUEUE_IS_EMPTY,
+
+    VALUE_NOT_FOUND,
+
+    LIST_IS_FULL,
+
+    FILE_ERR,
 };
 
-ListErrors ListCtor  (ListType* list, const size_t capacity = 0);
-ListErrors ListCopy  (const ListType* source, ListType* target);
+ListErrors ListCtor  (ListType* list, const size_t capacity = 0,
+                      const ListAllocatorType* allocator = nullptr);
+/// @brief Deep copy into not constructed target, allocator of source is used if none is given
+ListErrors ListCopy  (const ListType* source, ListType* target,
+                      const ListAllocatorType* allocator = nullptr);
 ListErrors ListDtor  (ListType* list);
 ListErrors ListVerify(ListType* list);
 ListErrors ListInsert(ListType* list, const size_t anchorPos, const int value, 
                       size_t* insertedValPos);
 ListErrors ListErase (ListType* list, const size_t anchorPos);
 
+/// @brief Unlinks element from list but does not give its slot back to free blocks
+/// @details Element keeps its links. Slot has to be given back with ListReleaseSlot.
+ListErrors ListDetach     (ListType* list, const size_t anchorPos);
+ListErrors ListReleaseSlot(ListType* list, const size_t pos);
+
+/// @brief Relinks element at pos before anchorPos, element keeps its slot
+/// @details O(1), no allocation. Used to move elements to front of recency lists.
+ListErrors ListMoveBefore (ListType* list, const size_t pos, const size_t anchorPos);
+
 ListErrors ListCapacityDecrease(ListType* list);
 
+/// @brief Updates indexes, trace and journal after elements moved to other slots
+/// @details Checks list by its verifyLevel. Called by all operations relayouting list.
+ListErrors ListIndexesRebuild(ListType* list);
+
+/// @brief Checks list as its operations do: by its verifyLevel, nothing for NONE
+ListErrors ListVerifyByLevel(ListType* list);
+
+void       ListSetAllocPolicy (ListType* list, const ListAllocPolicy policy);
+void       ListSetVerifyLevel(ListType* list, const ListVerifyLevel level);
+
+struct ListFragmentationType
+{
+    double nonSequentialLinks; ///< share of links not going to next slot, 0 for linear list
+    double meanLinkDistance;   ///< mean distance in slots between neighbour elements
+};
+
+ListErrors ListGetFragmentation(ListType* list, ListFragmentationType* fragmentation);
+
+/// @brief Comparator as in qsort: negative if a < b, zero if equal, positive if a > b
+typedef int (*ListCmpFuncType)(const int a, const int b);
+
+enum class ListSortStrategy
+{
+    AUTO,       ///< physical for big dense lists, relinking otherwise
+    RELINK,     ///< merge sort by relinking, no allocation, positions keep their values
+    PHYSICAL,   ///< values are sorted in array and written to slots 1..size with linear links
+};
+
+/// @brief Stable sort of list
+/// @details PHYSICAL strategy changes positions of elements
+ListErrors ListSort(ListType* list, ListCmpFuncType cmp,
+                    const ListSortStrategy strategy = ListSortStrategy::AUTO);
+
 ListErrors ListGetNextElem (ListType* list, size_t pos, size_t *nextElemPos);
 ListErrors ListGetPrevElem (ListType* list, size_t pos, size_t *prevElemPos);
 ListErrors ListGetElemValue(ListType* list, size_t pos, int* elemValue);
@@ -57,6 +149,10 @@ ListErrors ListSetElemValue(ListType* list, size_t pos, int  newElemValue);
 size_t ListGetHead(const ListType* list);
 size_t ListGetTail(const ListType* list);
 
+/// @brief Checks if slot at pos is in free blocks, used by physical scans of data
+/// @details Checks occupancy bitmap, so any value including poison can be stored
+bool   ListIsElemFree(const ListType* list, const size_t pos);
+
 #define LIST_TEXT_DUMP(list) ListTextDump((list), __FILE__, __func__, __LINE__)
 void ListTextDump(const ListType* list, const char* fileName,
                                         const char* funcName,
@@ -69,6 +165,9 @@ void ListDump(const ListType* list, const char* fileName,
                                     const char* funcName,
                                     const int line);
 
+/// @brief Text of error ending with new line
+const char* ListErrorsGetMessage(const ListErrors error);
+
 #define LIST_ERRORS_LOG_ERROR(error) ListErrorsLogError((error), __FILE__, __func__, __LINE__)
 void ListErrorsLogError(ListErrors error, const char* fileName,
                                           const char* funcName,
@@ -0,0 +1,309 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+#include "ListAllocator.h"
+
+static const size_t HugePageSize = 2 * 1024 * 1024;
+
+static inline size_t RoundUp(const size_t value, const size_t alignment);
+static        void*  CopyToNewBlock(const ListAllocatorType* allocator,
+                                    void* ptr, const size_t oldSize,
+                                               const size_t newSize,
+                                               const size_t alignment);
+
+//-------Standard allocator---------
+
+static void* StandardAlloc  (void* context, const size_t size, const size_t alignment);
+static void* StandardRealloc(void* context, void* ptr, const size_t oldSize,
+                                                       const size_t newSize,
+                                                       const size_t alignment);
+static void  StandardFree   (void* context, void* ptr, const size_t size);
+
+//-------Huge page allocator---------
+
+static void* HugePageAlloc  (void* context, const size_t size, const size_t alignment);
+static void* HugePageRealloc(void* context, void* ptr, const size_t oldSize,
+                                                       const size_t newSize,
+                                                       const size_t alignment);
+
+//-------NUMA allocator---------
+
+static void* NumaAlloc  (void* context, const size_t size, const size_t alignment);
+static void* NumaRealloc(void* context, void* ptr, const size_t oldSize,
+                                                   const size_t newSize,
+                                                   const size_t alignment);
+static void  NumaFree   (void* context, void* ptr, const size_t size);
+
+//-------Arena allocator---------
+
+static void* ArenaAlloc  (void* context, const size_t size, const size_t alignment);
+static void* ArenaRealloc(void* context, void* ptr, const size_t oldSize,
+                                                    const size_t newSize,
+                                                    const size_t alignment);
+static void  ArenaFree   (void* context, void* ptr, const size_t size);
+
+ListAllocatorType ListStandardAllocator()
+{
+    return { StandardAlloc, StandardRealloc, StandardFree, nullptr };
+}
+
+ListAllocatorType ListHugePageAllocator()
+{
+    return { HugePageAlloc, HugePageRealloc, StandardFree, nullptr };
+}
+
+ListAllocatorType ListNumaAllocator(ListNumaContextType* numaContext)
+{
+    assert(numaContext);
+
+    return { NumaAlloc, NumaRealloc, NumaFree, numaContext };
+}
+
+ListAllocatorType ListArenaAllocator(ListArenaType* arena)
+{
+    assert(arena);
+
+    return { ArenaAlloc, ArenaRealloc, ArenaFree, arena };
+}
+
+static inline size_t RoundUp(const size_t value, const size_t alignment)
+{
+    assert(alignment != 0);
+
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static void* CopyToNewBlock(const ListAllocatorType* allocator,
+                            void* ptr, const size_t oldSize,
+                                       const size_t newSize,
+                                       const size_t alignment)
+{
+    assert(allocator);
+
+    void* newPtr = allocator->allocFunc(allocator->context, newSize, alignment);
+
+    if (newPtr == nullptr)
+        return nullptr;
+
+    if (ptr != nullptr)
+    {
+        memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+        allocator->freeFunc(allocator->context, ptr, oldSize);
+    }
+
+    return newPtr;
+}
+
+//-------Standard allocator---------
+
+static void* StandardAlloc(void* context, const size_t size, const size_t alignment)
+{
+    (void)context;
+
+    if (alignment <= alignof(max_align_t))
+        return malloc(size);
+
+    return aligned_alloc(alignment, RoundUp(size, alignment));
+}
+
+static void* StandardRealloc(void* context, void* ptr, const size_t oldSize,
+                                                       const size_t newSize,
+                                                       const size_t alignment)
+{
+    if (alignment <= alignof(max_align_t))
+        return realloc(ptr, newSize);
+
+    //realloc does not keep alignment
+    const ListAllocatorType allocator = { StandardAlloc, StandardRealloc, StandardFree, context };
+    return CopyToNewBlock(&allocator, ptr, oldSize, newSize, alignment);
+}
+
+static void StandardFree(void* context, void* ptr, const size_t size)
+{
+    (void)context;
+    (void)size;
+
+    free(ptr);
+}
+
+//-------Huge page allocator---------
+
+static void* HugePageAlloc(void* context, const size_t size, const size_t alignment)
+{
+    if (size < HugePageSize)
+        return StandardAlloc(context, size, alignment);
+
+    const size_t blockSize = RoundUp(size, HugePageSize);
+    void* block = aligned_alloc(HugePageSize, blockSize);
+
+    if (block == nullptr)
+        return nullptr;
+
+    //only advice, block is usable even if transparent huge pages are off
+    madvise(block, blockSize, MADV_HUGEPAGE);
+
+    return block;
+}
+
+static void* HugePageRealloc(void* context, void* ptr, const size_t oldSize,
+                                                       const size_t newSize,
+                                                       const size_t alignment)
+{
+    if (oldSize < HugePageSize && newSize < HugePageSize)
+        return StandardRealloc(context, ptr, oldSize, newSize, alignment);
+
+    //only block given by huge page branch is rounded up, small one has exactly oldSize
+    if (oldSize >= HugePageSize &&
+        RoundUp(oldSize, HugePageSize) == RoundUp(newSize, HugePageSize))
+        return ptr;
+
+    const ListAllocatorType allocator = ListHugePageAllocator();
+    return CopyToNewBlock(&allocator, ptr, oldSize, newSize, alignment);
+}
+
+//-------NUMA allocator---------
+
+static void* NumaAlloc(void* context, const size_t size, const size_t alignment)
+{
+    assert(context);
+
+    const ListNumaContextType* numaContext = (const ListNumaContextType*)context;
+
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    assert(alignment <= pageSize);
+    (void)alignment;
+
+    const size_t blockSize = RoundUp(size, pageSize);
+    void* block = mmap(nullptr, blockSize, PROT_READ | PROT_WRITE,
+                                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (block == MAP_FAILED)
+        return nullptr;
+
+    static const size_t maxNode = sizeof(unsigned long) * 8;
+    assert(numaContext->node >= 0 && (size_t)numaContext->node < maxNode);
+
+    unsigned long nodeMask = 1ul << numaContext->node;
+
+    //pages are not touched yet, so binding places them on the node at first write
+    syscall(SYS_mbind, block, blockSize, MPOL_BIND, &nodeMask, maxNode, 0);
+
+    return block;
+}
+
+static void* NumaRealloc(void* context, void* ptr, const size_t oldSize,
+                                                   const size_t newSize,
+                                                   const size_t alignment)
+{
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+
+    if (ptr != nullptr && RoundUp(oldSize, pageSize) == RoundUp(newSize, pageSize))
+        return ptr;
+
+    const ListAllocatorType allocator = { NumaAlloc, NumaRealloc, NumaFree, context };
+    return CopyToNewBlock(&allocator, ptr, oldSize, newSize, alignment);
+}
+
+static void NumaFree(void* context, void* ptr, const size_t size)
+{
+    (void)context;
+
+    if (ptr == nullptr)
+        return;
+
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    munmap(ptr, RoundUp(size, pageSize));
+}
+
+//-------Arena allocator---------
+
+bool ListArenaCtor(ListArenaType* arena, const size_t capacity)
+{
+    assert(arena);
+
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+
+    arena->capacity        = RoundUp(capacity, pageSize);
+    arena->used            = 0;
+    arena->lastBlockOffset = 0;
+
+    void* memory = mmap(nullptr, arena->capacity, PROT_READ | PROT_WRITE,
+                                                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (memory == MAP_FAILED)
+    {
+        arena->memory   = nullptr;
+        arena->capacity = 0;
+
+        return false;
+    }
+
+    if (arena->capacity >= HugePageSize)
+        madvise(memory, arena->capacity, MADV_HUGEPAGE);
+
+    arena->memory = (char*)memory;
+
+    return true;
+}
+
+void ListArenaDtor(ListArenaType* arena)
+{
+    assert(arena);
+
+    if (arena->memory != nullptr)
+        munmap(arena->memory, arena->capacity);
+
+    arena->memory   = nullptr;
+    arena->capacity = arena->used = arena->lastBlockOffset = 0;
+}
+
+static void* ArenaAlloc(void* context, const size_t size, const size_t alignment)
+{
+    assert(context);
+
+    ListArenaType* arena = (ListArenaType*)context;
+
+    const size_t blockOffset = RoundUp(arena->used, alignment);
+
+    if (blockOffset > arena->capacity || arena->capacity - blockOffset < size)
+        return nullptr;
+
+    arena->lastBlockOffset = blockOffset;
+    arena->used            = blockOffset + size;
+
+    return arena->memory + blockOffset;
+}
+
+static void* ArenaRealloc(void* context, void* ptr, const size_t oldSize,
+                                                    const size_t newSize,
+                                                    const size_t alignment)
+{
+    assert(context);
+
+    ListArenaType* arena = (ListArenaType*)context;
+
+    const bool isLastBlock = ptr != nullptr &&
+                             (char*)ptr == arena->memory + arena->lastBlockOffset;
+
+    if (isLastBlock && arena->capacity - arena->lastBlockOffset >= newSize)
+    {
+        arena->used = arena->lastBlockOffset + newSize;
+        return ptr;
+    }
+
+    const ListAllocatorType allocator = ListArenaAllocator(arena);
+    return CopyToNewBlock(&allocator, ptr, oldSize, newSize, alignment);
+}
+
+static void ArenaFree(void* context, void* ptr, const size_t size)
+{
+    (void)context;
+    (void)ptr;
+    (void)size;
+}
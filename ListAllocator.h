@@ -0,0 +1,64 @@
+#ifndef LIST_ALLOCATOR_H
+#define LIST_ALLOCATOR_H
+
+#include <stddef.h>
+
+/// \file
+/// \brief Allocator interface used for list storage and its built-in implementations.
+/// \details Allocator is passed by pointer at construction and copied into the list,
+///          context has to outlive the list.
+
+struct ListAllocatorType
+{
+    /// @brief allocates size bytes aligned to alignment, returns nullptr on failure
+    void* (*allocFunc)  (void* context, const size_t size, const size_t alignment);
+
+    /// @brief resizes block keeping its content, returns nullptr and keeps old block on failure
+    void* (*reallocFunc)(void* context, void* ptr, const size_t oldSize,
+                                                   const size_t newSize,
+                                                   const size_t alignment);
+
+    /// @brief frees block allocated with allocFunc or reallocFunc
+    void  (*freeFunc)   (void* context, void* ptr, const size_t size);
+
+    void* context;
+};
+
+/// @brief malloc / realloc / free based allocator used when no allocator is given
+ListAllocatorType ListStandardAllocator();
+
+/// @brief Allocator backing big blocks with 2 MiB aligned memory advised with MADV_HUGEPAGE
+/// @details Blocks smaller than a huge page are given by standard allocator
+ListAllocatorType ListHugePageAllocator();
+
+//-----------------------------------------------------------------------------------------------
+
+struct ListNumaContextType
+{
+    int node; ///< NUMA node memory is bound to
+};
+
+/// @brief Allocator binding memory to numaContext->node with mbind
+/// @details Binding is best effort: memory is still given if kernel has no NUMA support
+ListAllocatorType ListNumaAllocator(ListNumaContextType* numaContext);
+
+//-----------------------------------------------------------------------------------------------
+
+/// \brief Monotonic arena. Free is no-op, memory is returned at once by ListArenaDtor.
+struct ListArenaType
+{
+    char* memory;
+
+    size_t capacity;
+    size_t used;
+
+    size_t lastBlockOffset; ///< last given block can be resized in place
+};
+
+bool ListArenaCtor(ListArenaType* arena, const size_t capacity);
+void ListArenaDtor(ListArenaType* arena);
+
+/// @brief Allocator giving memory from arena
+ListAllocatorType ListArenaAllocator(ListArenaType* arena);
+
+#endif
@@ -0,0 +1,1029 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Log.h"
+#include "List.h"
+#include "ListParallel.h"
+#include "ListQueue.h"
+#include "ListSharded.h"
+#include "XorList.h"
+
+struct BenchConfigType
+{
+    const char* benchName;
+
+    size_t count;           ///< operations per thread or elements, depends on bench
+    size_t threadsCount;
+};
+
+typedef bool (*BenchFuncType)(const BenchConfigType* config);
+
+struct BenchType
+{
+    const char*   name;
+    BenchFuncType func;
+    const char*   description;
+};
+
+static bool BenchQueue(const BenchConfigType* config);
+static bool BenchSort (const BenchConfigType* config);
+static bool BenchAllocPolicy(const BenchConfigType* config);
+static bool BenchXor  (const BenchConfigType* config);
+static bool BenchRebuild(const BenchConfigType* config);
+static bool BenchParallelWalk(const BenchConfigType* config);
+static bool BenchSharded(const BenchConfigType* config);
+
+static const BenchType Benches[] =
+{
+    { "queue", BenchQueue, "SPSC/MPSC ListQueue vs ListInsert/ListErase behind mutex" },
+    { "sort",  BenchSort,  "ListSort strategies vs std::list::sort, --count elements" },
+    { "alloc-policy", BenchAllocPolicy,
+      "traversal after mixed inserts/erases with FREE_HEAD and NEAR_ANCHOR slots" },
+    { "xor",   BenchXor,   "memory and traversal of XorList vs ListType, --count elements" },
+    { "rebuild", BenchRebuild,
+      "ListParallelRebuild of shuffled list with 1..--threads threads" },
+    { "parallel-walk", BenchParallelWalk,
+      "ListParallel ForEach, Reduce and ToArray with 1..--threads threads vs serial walk" },
+    { "sharded", BenchSharded,
+      "--count appends per thread to ListSharded vs one list behind mutex, consolidation" },
+};
+
+static const size_t BenchesCount = sizeof(Benches) / sizeof(Benches[0]);
+
+static bool ParseArgs (const int argc, const char* argv[], BenchConfigType* config);
+static void PrintUsage(const char* programName);
+
+static void PrintRate (const char* name, const size_t opsCount, const uint64_t elapsedNs);
+
+static inline uint64_t NowNs();
+
+static ListErrors ShuffledListCtor(ListType* list, const size_t count, const unsigned seed);
+
+//-------Queue bench---------
+
+static uint64_t QueueRun(const ListQueueMode mode, const size_t producersCount,
+                                                   const size_t count);
+static uint64_t MutexListRun(const size_t producersCount, const size_t count);
+
+//-------Sort bench---------
+
+static ListErrors SortListsCtor(ListType* linear, ListType* shuffled, ListType* sparse,
+                                const size_t count);
+static uint64_t   SortRun      (const ListType* source, const ListSortStrategy strategy);
+static uint64_t   StdSortRun   (const size_t count);
+
+static int        IntCmp       (const int a, const int b);
+
+//-------Alloc policy bench---------
+
+static ListErrors MixedWorkloadRun(ListType* list, const ListAllocPolicy policy,
+                                   const size_t count);
+static uint64_t   TraversalRun    (const ListType* list, const size_t repeatsCount,
+                                   long long* sum);
+
+//-------Xor list bench---------
+
+static ListErrors XorListsCtor   (ListType* linear, ListType* shuffled, const size_t count);
+static ListErrors XorLayoutCopy  (const ListType* source, XorListType* target);
+static uint64_t   XorTraversalRun(const XorListType* list, const size_t repeatsCount,
+                                  long long* sum);
+
+//-------Parallel bench---------
+
+static uint64_t RebuildRun(const ListType* source, const size_t threadsCount);
+
+static void      CopyBySlot(const int value, const size_t pos, void* context);
+static long long Sum       (const long long accumulator, const long long value);
+
+//-------Sharded bench---------
+
+static uint64_t ShardedAppendRun(ListShardedType* sharded, const size_t threadsCount,
+                                 const size_t count);
+static uint64_t MutexAppendRun  (const size_t threadsCount, const size_t count);
+
+int main(const int argc, const char* argv[])
+{
+    LogOpen(argv[0]);
+
+    BenchConfigType config = { nullptr, 1000000, 4 };
+
+    if (!ParseArgs(argc, argv, &config))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < BenchesCount; ++i)
+    {
+        if (strcmp(config.benchName, "all")          != 0 &&
+            strcmp(config.benchName, Benches[i].name) != 0)
+            continue;
+
+        printf("== %s: %s\n", Benches[i].name, Benches[i].description);
+
+        if (!Benches[i].func(&config))
+        {
+            fprintf(stderr, "Bench %s failed\n", Benches[i].name);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static bool ParseArgs(const int argc, const char* argv[], BenchConfigType* config)
+{
+    assert(argv);
+    assert(config);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg     = argv[i];
+        const char* nextArg = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (nextArg != nullptr && strcmp(arg, "--count") == 0)
+            config->count        = strtoull(argv[++i], nullptr, 10);
+        else if (nextArg != nullptr && strcmp(arg, "--threads") == 0)
+            config->threadsCount = strtoull(argv[++i], nullptr, 10);
+        else if (arg[0] != '-' && config->benchName == nullptr)
+            config->benchName = arg;
+        else
+            return false;
+    }
+
+    if (config->benchName == nullptr || config->count == 0 || config->threadsCount == 0)
+        return false;
+
+    if (strcmp(config->benchName, "all") == 0)
+        return true;
+
+    for (size_t i = 0; i < BenchesCount; ++i)
+    {
+        if (strcmp(config->benchName, Benches[i].name) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+static void PrintUsage(const char* programName)
+{
+    assert(programName);
+
+    fprintf(stderr, "Usage: %s all|bench [--count N] [--threads N]\nBenches:\n", programName);
+
+    for (size_t i = 0; i < BenchesCount; ++i)
+        fprintf(stderr, "  %-14s %s\n", Benches[i].name, Benches[i].description);
+}
+
+static void PrintRate(const char* name, const size_t opsCount, const uint64_t elapsedNs)
+{
+    assert(name);
+
+    const double elapsedMs = (double)elapsedNs / 1e6;
+
+    printf("  %-32s %10.3f ms %10.3f Mops/s\n", name, elapsedMs,
+           elapsedNs == 0 ? 0 : (double)opsCount / elapsedMs / 1e3);
+}
+
+/// @brief Random values inserted before random elements, so neighbours are in far slots
+static ListErrors ShuffledListCtor(ListType* list, const size_t count, const unsigned seed)
+{
+    assert(list);
+
+    ListErrors error = ListCtor(list);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    ListSetVerifyLevel(list, ListVerifyLevel::NONE);
+
+    srand(seed);
+
+    std::vector<size_t> positions;
+    positions.reserve(count);
+
+    size_t pos = 0;
+    for (size_t i = 0; i < count && error == ListErrors::NO_ERR; ++i)
+    {
+        const size_t anchorPos = positions.empty() ? list->end :
+                                 positions[(size_t)rand() % positions.size()];
+
+        error = ListInsert(list, anchorPos, rand(), &pos);
+        positions.push_back(pos);
+    }
+
+    if (error == ListErrors::NO_ERR)
+        error = ListVerify(list);
+
+    if (error != ListErrors::NO_ERR)
+        ListDtor(list);
+
+    return error;
+}
+
+//-------Queue bench---------
+
+static const size_t QueueCapacity = 1 << 16;
+
+static bool BenchQueue(const BenchConfigType* config)
+{
+    assert(config);
+
+    const size_t count   = config->count;
+    const size_t threads = config->threadsCount;
+
+    //every value is pushed once and popped once
+    PrintRate("SPSC ListQueue",            count, QueueRun(ListQueueMode::SPSC, 1, count));
+    PrintRate("1 producer, mutex + List",  count, MutexListRun(1, count));
+
+    PrintRate("MPSC ListQueue",            count * threads,
+              QueueRun(ListQueueMode::MPSC, threads, count));
+    PrintRate("N producers, mutex + List", count * threads, MutexListRun(threads, count));
+
+    return true;
+}
+
+static uint64_t QueueRun(const ListQueueMode mode, const size_t producersCount,
+                                                   const size_t count)
+{
+    ListQueueType* queue = new ListQueueType;
+
+    if (ListQueueCtor(queue, QueueCapacity, mode) != ListErrors::NO_ERR)
+    {
+        delete queue;
+        return 0;
+    }
+
+    const uint64_t beginNs = NowNs();
+
+    std::vector<std::thread> producers;
+    producers.reserve(producersCount);
+
+    for (size_t i = 0; i < producersCount; ++i)
+        producers.emplace_back([queue, count]()
+        {
+            for (size_t j = 0; j < count; ++j)
+            {
+                while (ListQueuePush(queue, (int)j) == ListErrors::QUEUE_IS_FULL)
+                    std::this_thread::yield();
+            }
+        });
+
+    int value = 0;
+    for (size_t popped = 0; popped < producersCount * count; )
+    {
+        if (ListQueuePop(queue, &value) == ListErrors::NO_ERR)
+            popped++;
+        else
+            std::this_thread::yield();
+    }
+
+    for (std::thread& producer : producers)
+        producer.join();
+
+    const uint64_t elapsedNs = NowNs() - beginNs;
+
+    ListQueueDtor(queue);
+    delete queue;
+
+    return elapsedNs;
+}
+
+static uint64_t MutexListRun(const size_t producersCount, const size_t count)
+{
+    ListType list = {};
+
+    if (ListCtor(&list, QueueCapacity) != ListErrors::NO_ERR)
+        return 0;
+
+    //verify is O(capacity), it would measure checks instead of locking
+    ListSetVerifyLevel(&list, ListVerifyLevel::NONE);
+
+    std::mutex mutex;
+
+    const uint64_t beginNs = NowNs();
+
+    std::vector<std::thread> producers;
+    producers.reserve(producersCount);
+
+    for (size_t i = 0; i < producersCount; ++i)
+        producers.emplace_back([&list, &mutex, count]()
+        {
+            size_t pos = 0;
+
+            for (size_t j = 0; j < count; ++j)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ListInsert(&list, list.end, (int)j, &pos);
+            }
+        });
+
+    int value = 0;
+    for (size_t popped = 0; popped < producersCount * count; )
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (list.size == 0)
+        {
+            lock.unlock();
+            std::this_thread::yield();
+
+            continue;
+        }
+
+        const size_t head = ListGetHead(&list);
+
+        ListGetElemValue(&list, head, &value);
+        ListErase(&list, head);
+        popped++;
+    }
+
+    for (std::thread& producer : producers)
+        producer.join();
+
+    const uint64_t elapsedNs = NowNs() - beginNs;
+
+    ListDtor(&list);
+
+    return elapsedNs;
+}
+
+//-------Sort bench---------
+
+static const unsigned SortSeed = 12345;
+
+static bool BenchSort(const BenchConfigType* config)
+{
+    assert(config);
+
+    const size_t count = config->count;
+
+    ListType linear   = {};
+    ListType shuffled = {};
+    ListType sparse   = {};
+
+    if (SortListsCtor(&linear, &shuffled, &sparse, count) != ListErrors::NO_ERR)
+        return false;
+
+    PrintRate("std::list::sort", count, StdSortRun(count));
+
+    const struct
+    {
+        const char*     name;
+        const ListType* list;
+    } layouts[] =
+    {
+        { "linear",          &linear   },
+        { "shuffled",        &shuffled },
+        { "sparse shuffled", &sparse   },
+    };
+
+    const struct
+    {
+        const char*      name;
+        ListSortStrategy strategy;
+    } strategies[] =
+    {
+        { "relink",   ListSortStrategy::RELINK   },
+        { "physical", ListSortStrategy::PHYSICAL },
+        { "auto",     ListSortStrategy::AUTO     },
+    };
+
+    char name[64] = "";
+
+    for (const auto& layout : layouts)
+    {
+        for (const auto& strategy : strategies)
+        {
+            snprintf(name, sizeof(name), "%s, %s", layout.name, strategy.name);
+            PrintRate(name, count, SortRun(layout.list, strategy.strategy));
+        }
+    }
+
+    ListDtor(&linear);
+    ListDtor(&shuffled);
+    ListDtor(&sparse);
+
+    return true;
+}
+
+/// @brief Same random values laid out linearly, in shuffled slots and in quarter full list
+static ListErrors SortListsCtor(ListType* linear, ListType* shuffled, ListType* sparse,
+                                const size_t count)
+{
+    assert(linear);
+    assert(shuffled);
+    assert(sparse);
+
+    if (ListCtor(linear)   != ListErrors::NO_ERR ||
+        ListCtor(shuffled) != ListErrors::NO_ERR ||
+        ListCtor(sparse)   != ListErrors::NO_ERR)
+        return ListErrors::MEMORY_ERR;
+
+    ListSetVerifyLevel(linear,   ListVerifyLevel::NONE);
+    ListSetVerifyLevel(shuffled, ListVerifyLevel::NONE);
+    ListSetVerifyLevel(sparse,   ListVerifyLevel::NONE);
+
+    srand(SortSeed);
+
+    std::vector<size_t> positions;
+    positions.reserve(count * 4);
+
+    size_t pos = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const int value = rand();
+
+        ListInsert(linear, linear->end, value, &pos);
+
+        //inserting before random element puts neighbours into far slots
+        const size_t anchorPos = positions.empty() ? shuffled->end :
+                                 positions[(size_t)rand() % positions.size()];
+        ListInsert(shuffled, anchorPos, value, &pos);
+        positions.push_back(pos);
+    }
+
+    positions.clear();
+
+    for (size_t i = 0; i < count * 4; ++i)
+    {
+        const size_t anchorPos = positions.empty() ? sparse->end :
+                                 positions[(size_t)rand() % positions.size()];
+        ListInsert(sparse, anchorPos, rand(), &pos);
+        positions.push_back(pos);
+    }
+
+    for (size_t i = 0; i < count * 3; ++i)
+    {
+        const size_t index = (size_t)rand() % positions.size();
+
+        ListErase(sparse, positions[index]);
+
+        positions[index] = positions.back();
+        positions.pop_back();
+    }
+
+    return ListVerify(linear) != ListErrors::NO_ERR   ? ListErrors::INVALID_DATA :
+           ListVerify(shuffled) != ListErrors::NO_ERR ? ListErrors::INVALID_DATA :
+                                                        ListVerify(sparse);
+}
+
+static uint64_t SortRun(const ListType* source, const ListSortStrategy strategy)
+{
+    assert(source);
+
+    ListType list = {};
+
+    if (ListCopy(source, &list) != ListErrors::NO_ERR)
+        return 0;
+
+    const uint64_t beginNs = NowNs();
+
+    ListSort(&list, IntCmp, strategy);
+
+    const uint64_t elapsedNs = NowNs() - beginNs;
+
+    ListDtor(&list);
+
+    return elapsedNs;
+}
+
+static uint64_t StdSortRun(const size_t count)
+{
+    srand(SortSeed);
+
+    std::list<int> list;
+    for (size_t i = 0; i < count; ++i)
+        list.push_back(rand());
+
+    const uint64_t beginNs = NowNs();
+
+    list.sort();
+
+    return NowNs() - beginNs;
+}
+
+static int IntCmp(const int a, const int b)
+{
+    return (a > b) - (a < b);
+}
+
+//-------Alloc policy bench---------
+
+static const unsigned AllocPolicySeed       = 54321;
+static const size_t   TraversalRepeatsCount = 10;
+
+static volatile long long TraversalSink = 0;
+
+static bool BenchAllocPolicy(const BenchConfigType* config)
+{
+    assert(config);
+
+    const struct
+    {
+        const char*     name;
+        ListAllocPolicy policy;
+    } policies[] =
+    {
+        { "free-head",   ListAllocPolicy::FREE_HEAD   },
+        { "near-anchor", ListAllocPolicy::NEAR_ANCHOR },
+    };
+
+    char name[64] = "";
+
+    for (const auto& policy : policies)
+    {
+        ListType list = {};
+
+        if (MixedWorkloadRun(&list, policy.policy, config->count) != ListErrors::NO_ERR)
+            return false;
+
+        ListFragmentationType fragmentation = {};
+        ListGetFragmentation(&list, &fragmentation);
+
+        printf("  %s: %zu elements, non-sequential links %.3f, mean link distance %.1f\n",
+               policy.name, list.size, fragmentation.nonSequentialLinks,
+                                       fragmentation.meanLinkDistance);
+
+        long long sum = 0;
+        const uint64_t elapsedNs = TraversalRun(&list, TraversalRepeatsCount, &sum);
+
+        snprintf(name, sizeof(name), "%s traversal", policy.name);
+        PrintRate(name, list.size * TraversalRepeatsCount, elapsedNs);
+
+        ListDtor(&list);
+    }
+
+    return true;
+}
+
+/// @brief Appends count elements, then makes count rounds of erase and insert before
+///        random element, as long-lived list does
+static ListErrors MixedWorkloadRun(ListType* list, const ListAllocPolicy policy,
+                                   const size_t count)
+{
+    assert(list);
+
+    ListErrors error = ListCtor(list);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    ListSetVerifyLevel(list, ListVerifyLevel::NONE);
+    ListSetAllocPolicy(list, policy);
+
+    //the same operations for every policy
+    srand(AllocPolicySeed);
+
+    std::vector<size_t> positions;
+    positions.reserve(count);
+
+    size_t pos = 0;
+    for (size_t i = 0; i < count && error == ListErrors::NO_ERR; ++i)
+    {
+        error = ListInsert(list, list->end, rand(), &pos);
+        positions.push_back(pos);
+    }
+
+    for (size_t i = 0; i < count && error == ListErrors::NO_ERR; ++i)
+    {
+        size_t index = (size_t)rand() % positions.size();
+        ListErase(list, positions[index]);
+
+        positions[index] = positions.back();
+        positions.pop_back();
+
+        index = (size_t)rand() % positions.size();
+        error = ListInsert(list, positions[index], rand(), &pos);
+        positions.push_back(pos);
+    }
+
+    if (error == ListErrors::NO_ERR)
+        error = ListVerify(list);
+
+    if (error != ListErrors::NO_ERR)
+        ListDtor(list);
+
+    return error;
+}
+
+static uint64_t TraversalRun(const ListType* list, const size_t repeatsCount, long long* sum)
+{
+    assert(list);
+    assert(sum);
+
+    const uint64_t beginNs = NowNs();
+
+    for (size_t i = 0; i < repeatsCount; ++i)
+    {
+        long long passSum = 0;
+
+        for (size_t pos = ListGetHead(list); pos != list->end; pos = list->data[pos].nextPos)
+            passSum += list->data[pos].value;
+
+        //volatile store keeps walk between time points, optimizer could move it otherwise
+        TraversalSink = passSum;
+        *sum += passSum;
+    }
+
+    return NowNs() - beginNs;
+}
+
+//-------Xor list bench---------
+
+static const unsigned XorSeed = 24680;
+
+static bool BenchXor(const BenchConfigType* config)
+{
+    assert(config);
+
+    ListType linear   = {};
+    ListType shuffled = {};
+
+    if (XorListsCtor(&linear, &shuffled, config->count) != ListErrors::NO_ERR)
+        return false;
+
+    XorListType xorLinear   = {};
+    XorListType xorShuffled = {};
+
+    if (XorListFromList(&linear, &xorLinear)    != ListErrors::NO_ERR ||
+        XorLayoutCopy  (&shuffled, &xorShuffled) != ListErrors::NO_ERR)
+        return false;
+
+    //list keeps occupancy bitmap besides slots
+    const size_t listBytes = linear.capacity * sizeof(ListElemType) +
+                             (linear.capacity + 63) / 64 * sizeof(uint64_t);
+    const size_t xorBytes  = xorLinear.capacity * sizeof(XorListElemType);
+
+    printf("  memory: list %.1f MiB (%zu slots, %.2f bytes per element), "
+           "xor list %.1f MiB (%zu slots, %.2f bytes per element)\n",
+           (double)listBytes / (1 << 20), linear.capacity,
+           (double)listBytes / (double)linear.size,
+           (double)xorBytes  / (1 << 20), xorLinear.capacity,
+           (double)xorBytes  / (double)xorLinear.size);
+
+    long long listSum = 0;
+    long long xorSum  = 0;
+
+    PrintRate("linear list traversal", linear.size * TraversalRepeatsCount,
+              TraversalRun(&linear, TraversalRepeatsCount, &listSum));
+    PrintRate("linear xor list traversal", xorLinear.size * TraversalRepeatsCount,
+              XorTraversalRun(&xorLinear, TraversalRepeatsCount, &xorSum));
+
+    PrintRate("shuffled list traversal", shuffled.size * TraversalRepeatsCount,
+              TraversalRun(&shuffled, TraversalRepeatsCount, &listSum));
+    PrintRate("shuffled xor list traversal", xorShuffled.size * TraversalRepeatsCount,
+              XorTraversalRun(&xorShuffled, TraversalRepeatsCount, &xorSum));
+
+    ListDtor(&linear);
+    ListDtor(&shuffled);
+    XorListDtor(&xorLinear);
+    XorListDtor(&xorShuffled);
+
+    //both layouts hold the same values, so walks must agree
+    return listSum == xorSum;
+}
+
+/// @brief Same random values appended and inserted before random elements
+static ListErrors XorListsCtor(ListType* linear, ListType* shuffled, const size_t count)
+{
+    assert(linear);
+    assert(shuffled);
+
+    //exact capacity as XorListFromList takes, growth by doubling would skew memory
+    if (ListCtor(linear, count + 1) != ListErrors::NO_ERR ||
+        ListCtor(shuffled)          != ListErrors::NO_ERR)
+        return ListErrors::MEMORY_ERR;
+
+    ListSetVerifyLevel(linear,   ListVerifyLevel::NONE);
+    ListSetVerifyLevel(shuffled, ListVerifyLevel::NONE);
+
+    srand(XorSeed);
+
+    std::vector<size_t> positions;
+    positions.reserve(count);
+
+    size_t pos = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const int value = rand();
+
+        ListInsert(linear, linear->end, value, &pos);
+
+        const size_t anchorPos = positions.empty() ? shuffled->end :
+                                 positions[(size_t)rand() % positions.size()];
+        ListInsert(shuffled, anchorPos, value, &pos);
+        positions.push_back(pos);
+    }
+
+    return ListVerify(linear) != ListErrors::NO_ERR ? ListErrors::INVALID_DATA :
+                                                      ListVerify(shuffled);
+}
+
+/// @brief Builds xor list keeping slots of source, so walk touches the same addresses
+/// @details Source must only have had inserts, so its elements are in slots 1..size
+static ListErrors XorLayoutCopy(const ListType* source, XorListType* target)
+{
+    assert(source);
+    assert(target);
+
+    ListErrors error = XorListCtor(target, source->size + 1);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    size_t prevPos = source->end;
+    for (size_t pos = ListGetHead(source); pos != source->end; pos = source->data[pos].nextPos)
+    {
+        if (pos > source->size)
+        {
+            XorListDtor(target);
+            return ListErrors::OUT_OF_RANGE;
+        }
+
+        target->data[pos].value = source->data[pos].value;
+        target->data[pos].link  = prevPos ^ source->data[pos].nextPos;
+
+        prevPos = pos;
+    }
+
+    //slots after size stay chained free by ctor
+    target->size          = source->size;
+    target->tail          = ListGetTail(source);
+    target->freeBlockHead = source->size + 1 < target->capacity ? source->size + 1 : 0;
+
+    target->data[target->end].link = ListGetHead(source) ^ target->tail;
+
+    return XorListVerify(target);
+}
+
+static uint64_t XorTraversalRun(const XorListType* list, const size_t repeatsCount,
+                                long long* sum)
+{
+    assert(list);
+    assert(sum);
+
+    const uint64_t beginNs = NowNs();
+
+    for (size_t i = 0; i < repeatsCount; ++i)
+    {
+        long long passSum = 0;
+
+        for (XorListIterType iter = XorListBegin(list); !XorListIterIsEnd(list, iter);
+                             iter = XorListIterNext(list, iter))
+            passSum += list->data[iter.pos].value;
+
+        TraversalSink = passSum;
+        *sum += passSum;
+    }
+
+    return NowNs() - beginNs;
+}
+
+//-------Parallel bench---------
+
+static const unsigned ParallelSeed = 13579;
+
+static bool BenchRebuild(const BenchConfigType* config)
+{
+    assert(config);
+
+    ListType shuffled = {};
+
+    if (ShuffledListCtor(&shuffled, config->count, ParallelSeed) != ListErrors::NO_ERR)
+        return false;
+
+    char name[64] = "";
+
+    //one thread is serial baseline
+    for (size_t threadsCount = 1; threadsCount <= config->threadsCount; threadsCount *= 2)
+    {
+        const uint64_t elapsedNs = RebuildRun(&shuffled, threadsCount);
+
+        if (elapsedNs == 0)
+        {
+            ListDtor(&shuffled);
+            return false;
+        }
+
+        snprintf(name, sizeof(name), "rebuild, %zu thread(s)", threadsCount);
+        PrintRate(name, shuffled.size, elapsedNs);
+    }
+
+    ListDtor(&shuffled);
+
+    return true;
+}
+
+static bool BenchParallelWalk(const BenchConfigType* config)
+{
+    assert(config);
+
+    ListType list = {};
+
+    if (ShuffledListCtor(&list, config->count, ParallelSeed) != ListErrors::NO_ERR)
+        return false;
+
+    //ForEach writes values by slot, ToArray writes them in list order
+    std::vector<int> values(list.capacity);
+
+    long long serialSum = 0;
+    PrintRate("serial walk", list.size, TraversalRun(&list, 1, &serialSum));
+
+    const size_t size = list.size;
+
+    char name[64] = "";
+    bool isCorrect = true;
+
+    for (size_t threadsCount = 1; threadsCount <= config->threadsCount; threadsCount *= 2)
+    {
+        uint64_t beginNs = NowNs();
+        isCorrect &= ListParallelForEach(&list, CopyBySlot, values.data(), threadsCount) ==
+                     ListErrors::NO_ERR;
+        uint64_t elapsedNs = NowNs() - beginNs;
+
+        snprintf(name, sizeof(name), "for each, %zu thread(s)", threadsCount);
+        PrintRate(name, size, elapsedNs);
+
+        long long sum = 0;
+
+        beginNs = NowNs();
+        isCorrect &= ListParallelReduce(&list, Sum, 0, &sum, threadsCount) == ListErrors::NO_ERR;
+        elapsedNs = NowNs() - beginNs;
+
+        isCorrect &= sum == serialSum;
+
+        snprintf(name, sizeof(name), "reduce, %zu thread(s)", threadsCount);
+        PrintRate(name, size, elapsedNs);
+
+        beginNs = NowNs();
+        isCorrect &= ListParallelToArray(&list, values.data(), threadsCount) ==
+                     ListErrors::NO_ERR;
+        elapsedNs = NowNs() - beginNs;
+
+        isCorrect &= values[0] == list.data[ListGetHead(&list)].value;
+
+        snprintf(name, sizeof(name), "to array, %zu thread(s)", threadsCount);
+        PrintRate(name, size, elapsedNs);
+    }
+
+    ListDtor(&list);
+
+    return isCorrect;
+}
+
+/// @return time of rebuild of copy of source, 0 on failure
+static uint64_t RebuildRun(const ListType* source, const size_t threadsCount)
+{
+    assert(source);
+
+    ListType list = {};
+
+    if (ListCopy(source, &list) != ListErrors::NO_ERR)
+        return 0;
+
+    ListSetVerifyLevel(&list, ListVerifyLevel::NONE);
+
+    const uint64_t beginNs = NowNs();
+
+    const ListErrors error = ListParallelRebuild(&list, threadsCount);
+
+    const uint64_t elapsedNs = NowNs() - beginNs;
+
+    const bool isRebuilt = error == ListErrors::NO_ERR && list.isLinear &&
+                           ListVerify(&list) == ListErrors::NO_ERR;
+
+    ListDtor(&list);
+
+    return isRebuilt ? elapsedNs : 0;
+}
+
+static void CopyBySlot(const int value, const size_t pos, void* context)
+{
+    assert(context);
+
+    ((int*)context)[pos] = value;
+}
+
+static long long Sum(const long long accumulator, const long long value)
+{
+    return accumulator + value;
+}
+
+//-------Sharded bench---------
+
+static bool BenchSharded(const BenchConfigType* config)
+{
+    assert(config);
+
+    const size_t count   = config->count;
+    const size_t threads = config->threadsCount;
+
+    ListShardedType sharded = {};
+
+    if (ListShardedCtor(&sharded, threads) != ListErrors::NO_ERR)
+        return false;
+
+    ListShardedSetVerifyLevel(&sharded, ListVerifyLevel::NONE);
+
+    PrintRate("ListSharded appends",  count * threads,
+              ShardedAppendRun(&sharded, threads, count));
+    PrintRate("mutex + List appends", count * threads, MutexAppendRun(threads, count));
+
+    ListType target = {};
+
+    const uint64_t beginNs = NowNs();
+    const ListErrors error = ListShardedConsolidate(&sharded, &target, threads);
+    const uint64_t elapsedNs = NowNs() - beginNs;
+
+    ListShardedDtor(&sharded);
+
+    if (error != ListErrors::NO_ERR)
+        return false;
+
+    PrintRate("consolidation", target.size, elapsedNs);
+
+    const bool isComplete = target.size == count * threads;
+
+    ListDtor(&target);
+
+    return isComplete;
+}
+
+static uint64_t ShardedAppendRun(ListShardedType* sharded, const size_t threadsCount,
+                                 const size_t count)
+{
+    assert(sharded);
+
+    const uint64_t beginNs = NowNs();
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount);
+
+    for (size_t i = 0; i < threadsCount; ++i)
+        threads.emplace_back([sharded, i, count]()
+        {
+            for (size_t j = 0; j < count; ++j)
+                ListShardedAppend(sharded, i, (int)j);
+        });
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    return NowNs() - beginNs;
+}
+
+static uint64_t MutexAppendRun(const size_t threadsCount, const size_t count)
+{
+    ListType list = {};
+
+    if (ListCtor(&list) != ListErrors::NO_ERR)
+        return 0;
+
+    ListSetVerifyLevel(&list, ListVerifyLevel::NONE);
+
+    std::mutex mutex;
+
+    const uint64_t beginNs = NowNs();
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount);
+
+    for (size_t i = 0; i < threadsCount; ++i)
+        threads.emplace_back([&list, &mutex, count]()
+        {
+            size_t pos = 0;
+
+            for (size_t j = 0; j < count; ++j)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ListInsert(&list, list.end, (int)j, &pos);
+            }
+        });
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    const uint64_t elapsedNs = NowNs() - beginNs;
+
+    ListDtor(&list);
+
+    return elapsedNs;
+}
+
+static inline uint64_t NowNs()
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
@@ -0,0 +1,89 @@
+#ifndef LIST_BITMAP_H
+#define LIST_BITMAP_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// \file
+/// \brief Bit per list slot helpers used for occupancy of list slots.
+/// \details Bits are stored in 64 bit words, bit i of word w is slot 64 * w + i.
+
+static const size_t ListBitmapWordBits = 64;
+
+inline size_t ListBitmapWordsCount(const size_t bitsCount)
+{
+    return (bitsCount + ListBitmapWordBits - 1) / ListBitmapWordBits;
+}
+
+inline bool ListBitmapTest(const uint64_t* bitmap, const size_t pos)
+{
+    assert(bitmap);
+
+    return (bitmap[pos / ListBitmapWordBits] >> (pos % ListBitmapWordBits)) & 1;
+}
+
+inline void ListBitmapSet(uint64_t* bitmap, const size_t pos)
+{
+    assert(bitmap);
+
+    bitmap[pos / ListBitmapWordBits] |=  (uint64_t)1 << (pos % ListBitmapWordBits);
+}
+
+inline void ListBitmapClear(uint64_t* bitmap, const size_t pos)
+{
+    assert(bitmap);
+
+    bitmap[pos / ListBitmapWordBits] &= ~((uint64_t)1 << (pos % ListBitmapWordBits));
+}
+
+/// @brief Sets (or clears) bits of [begin, end), whole words are written at once
+inline void ListBitmapAssignRange(uint64_t* bitmap, size_t begin, const size_t end,
+                                  const bool value)
+{
+    assert(bitmap);
+
+    for (; begin < end && begin % ListBitmapWordBits != 0; ++begin)
+        value ? ListBitmapSet(bitmap, begin) : ListBitmapClear(bitmap, begin);
+
+    for (; begin + ListBitmapWordBits <= end; begin += ListBitmapWordBits)
+        bitmap[begin / ListBitmapWordBits] = value ? ~(uint64_t)0 : 0;
+
+    for (; begin < end; ++begin)
+        value ? ListBitmapSet(bitmap, begin) : ListBitmapClear(bitmap, begin);
+}
+
+/// @brief Number of set bits in first wordsCount words
+inline size_t ListBitmapCount(const uint64_t* bitmap, const size_t wordsCount)
+{
+    assert(bitmap);
+
+    size_t count = 0;
+    for (size_t i = 0; i < wordsCount; ++i)
+        count += (size_t)__builtin_popcountll(bitmap[i]);
+
+    return count;
+}
+
+/// @brief First set bit in [pos, end) or end, zero words are skipped at once
+inline size_t ListBitmapFindNext(const uint64_t* bitmap, size_t pos, const size_t end)
+{
+    assert(bitmap);
+
+    while (pos < end)
+    {
+        const uint64_t word = bitmap[pos / ListBitmapWordBits] >> (pos % ListBitmapWordBits);
+
+        if (word != 0)
+        {
+            pos += (size_t)__builtin_ctzll(word);
+            return pos < end ? pos : end;
+        }
+
+        pos = (pos / ListBitmapWordBits + 1) * ListBitmapWordBits;
+    }
+
+    return end;
+}
+
+#endif
@@ -0,0 +1,349 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ListConcurrent.h"
+
+static const size_t RetiredMinCapacity  = 64;
+static const size_t ReclaimThreshold    = 64;
+
+static void* ConcurrentAlloc  (void* context, const size_t size, const size_t alignment);
+static void* ConcurrentRealloc(void* context, void* ptr, const size_t oldSize,
+                                                         const size_t newSize,
+                                                         const size_t alignment);
+static void  ConcurrentFree   (void* context, void* ptr, const size_t size);
+
+static void Retire(ListConcurrentType* clist, const size_t pos, void* data,
+                                                                const size_t dataSize);
+static void FreeRetired(ListConcurrentType* clist, const ListRetiredType* retired);
+static uint64_t GetMinReaderEpoch(ListConcurrentType* clist);
+
+ListErrors ListConcurrentCtor(ListConcurrentType* clist, const size_t maxReaders,
+                              const size_t capacity)
+{
+    assert(clist);
+    assert(maxReaders != 0);
+
+    clist->readers = (ListReaderEpochType*) aligned_alloc(alignof(ListReaderEpochType),
+                                                          maxReaders * sizeof(*clist->readers));
+
+    if (clist->readers == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    for (size_t i = 0; i < maxReaders; ++i)
+        clist->readers[i].epoch.store(0, std::memory_order_relaxed);
+
+    clist->readersCapacity = maxReaders;
+    clist->readersCount.store(0, std::memory_order_relaxed);
+
+    clist->retired = (ListRetiredType*) calloc(RetiredMinCapacity, sizeof(*clist->retired));
+
+    if (clist->retired == nullptr)
+    {
+        free(clist->readers);
+        return ListErrors::MEMORY_ERR;
+    }
+
+    clist->retiredCount    = 0;
+    clist->retiredCapacity = RetiredMinCapacity;
+
+    clist->globalEpoch.store(1, std::memory_order_relaxed);
+
+    const ListAllocatorType allocator = { ConcurrentAlloc, ConcurrentRealloc,
+                                          ConcurrentFree,  clist };
+
+    ListErrors error = ListCtor(&clist->list, capacity, &allocator);
+
+    if (error != ListErrors::NO_ERR)
+    {
+        free(clist->retired);
+        free(clist->readers);
+        return error;
+    }
+
+    clist->data.store(clist->list.data, std::memory_order_release);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListConcurrentDtor(ListConcurrentType* clist)
+{
+    assert(clist);
+
+    ListDtor(&clist->list);
+
+    //no readers are left, everything retired is freed at once
+    for (size_t i = 0; i < clist->retiredCount; ++i)
+    {
+        if (clist->retired[i].data != nullptr)
+            free(clist->retired[i].data);
+    }
+
+    free(clist->retired);
+    free(clist->readers);
+
+    clist->retired         = nullptr;
+    clist->retiredCount    = clist->retiredCapacity = 0;
+    clist->readers         = nullptr;
+    clist->readersCapacity = 0;
+
+    clist->data.store(nullptr, std::memory_order_relaxed);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListConcurrentReaderRegister(ListConcurrentType* clist, size_t* readerId)
+{
+    assert(clist);
+    assert(readerId);
+
+    const size_t newId = clist->readersCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (newId >= clist->readersCapacity)
+    {
+        clist->readersCount.fetch_sub(1, std::memory_order_relaxed);
+        return ListErrors::OUT_OF_RANGE;
+    }
+
+    *readerId = newId;
+
+    return ListErrors::NO_ERR;
+}
+
+//-------Reader side---------
+
+void ListConcurrentReadBegin(ListConcurrentType* clist, const size_t readerId)
+{
+    assert(clist);
+    assert(readerId < clist->readersCapacity);
+
+    clist->readers[readerId].epoch.store(clist->globalEpoch.load(std::memory_order_relaxed),
+                                         std::memory_order_relaxed);
+
+    //pairs with writer fence: either writer sees this epoch or reader sees unlinked state
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void ListConcurrentReadEnd(ListConcurrentType* clist, const size_t readerId)
+{
+    assert(clist);
+    assert(readerId < clist->readersCapacity);
+
+    clist->readers[readerId].epoch.store(0, std::memory_order_release);
+}
+
+size_t ListConcurrentGetHead(ListConcurrentType* clist)
+{
+    assert(clist);
+
+    ListElemType* data = clist->data.load(std::memory_order_acquire);
+
+    return __atomic_load_n(&data[clist->list.end].nextPos, __ATOMIC_ACQUIRE);
+}
+
+size_t ListConcurrentGetTail(ListConcurrentType* clist)
+{
+    assert(clist);
+
+    ListElemType* data = clist->data.load(std::memory_order_acquire);
+
+    return __atomic_load_n(&data[clist->list.end].prevPos, __ATOMIC_ACQUIRE);
+}
+
+size_t ListConcurrentGetNextElem(ListConcurrentType* clist, const size_t pos)
+{
+    assert(clist);
+
+    ListElemType* data = clist->data.load(std::memory_order_acquire);
+
+    return __atomic_load_n(&data[pos].nextPos, __ATOMIC_ACQUIRE);
+}
+
+size_t ListConcurrentGetPrevElem(ListConcurrentType* clist, const size_t pos)
+{
+    assert(clist);
+
+    ListElemType* data = clist->data.load(std::memory_order_acquire);
+
+    return __atomic_load_n(&data[pos].prevPos, __ATOMIC_ACQUIRE);
+}
+
+int ListConcurrentGetElemValue(ListConcurrentType* clist, const size_t pos)
+{
+    assert(clist);
+
+    ListElemType* data = clist->data.load(std::memory_order_acquire);
+
+    return __atomic_load_n(&data[pos].value, __ATOMIC_RELAXED);
+}
+
+//-------Writer side---------
+
+ListErrors ListConcurrentInsert(ListConcurrentType* clist, const size_t anchorPos,
+                                const int value, size_t* insertedValPos)
+{
+    assert(clist);
+    assert(insertedValPos);
+
+    //recycling retired slots is cheaper than growing
+    if (clist->list.freeBlockHead == 0 && clist->retiredCount != 0)
+        ListConcurrentReclaim(clist);
+
+    ListErrors error = ListInsert(&clist->list, anchorPos, value, insertedValPos);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    //data changes only on growth, old array is retired by allocator
+    if (clist->data.load(std::memory_order_relaxed) != clist->list.data)
+        clist->data.store(clist->list.data, std::memory_order_release);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListConcurrentErase(ListConcurrentType* clist, const size_t anchorPos)
+{
+    assert(clist);
+
+    ListErrors error = ListDetach(&clist->list, anchorPos);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    Retire(clist, anchorPos, nullptr, 0);
+
+    if (clist->retiredCount >= ReclaimThreshold)
+        ListConcurrentReclaim(clist);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListConcurrentSetElemValue(ListConcurrentType* clist, const size_t pos,
+                                      const int newElemValue)
+{
+    assert(clist);
+
+    return ListSetElemValue(&clist->list, pos, newElemValue);
+}
+
+void ListConcurrentReclaim(ListConcurrentType* clist)
+{
+    assert(clist);
+
+    //readers entering from now on can not see anything retired before
+    clist->globalEpoch.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const uint64_t minReaderEpoch = GetMinReaderEpoch(clist);
+
+    size_t keptCount = 0;
+    for (size_t i = 0; i < clist->retiredCount; ++i)
+    {
+        if (clist->retired[i].epoch < minReaderEpoch)
+            FreeRetired(clist, &clist->retired[i]);
+        else
+            clist->retired[keptCount++] = clist->retired[i];
+    }
+
+    clist->retiredCount = keptCount;
+}
+
+static uint64_t GetMinReaderEpoch(ListConcurrentType* clist)
+{
+    assert(clist);
+
+    uint64_t minEpoch = UINT64_MAX;
+
+    const size_t readersCount = clist->readersCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < readersCount && i < clist->readersCapacity; ++i)
+    {
+        const uint64_t readerEpoch = clist->readers[i].epoch.load(std::memory_order_acquire);
+
+        if (readerEpoch != 0 && readerEpoch < minEpoch)
+            minEpoch = readerEpoch;
+    }
+
+    return minEpoch;
+}
+
+static void FreeRetired(ListConcurrentType* clist, const ListRetiredType* retired)
+{
+    assert(clist);
+    assert(retired);
+
+    if (retired->data != nullptr)
+        free(retired->data);
+    else
+        ListReleaseSlot(&clist->list, retired->pos);
+}
+
+static void Retire(ListConcurrentType* clist, const size_t pos, void* data,
+                                                                const size_t dataSize)
+{
+    assert(clist);
+
+    //writer fence: unlinking or publishing new data is ordered before readers scan
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const ListRetiredType retired = { clist->globalEpoch.load(std::memory_order_relaxed),
+                                      pos, data, dataSize };
+
+    if (clist->retiredCount == clist->retiredCapacity)
+    {
+        const size_t newCapacity = clist->retiredCapacity * 2;
+        void* tmpPtr = realloc(clist->retired, newCapacity * sizeof(*clist->retired));
+
+        if (tmpPtr == nullptr)
+        {
+            //no place to defer, waiting for current readers instead
+            clist->globalEpoch.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            while (GetMinReaderEpoch(clist) <= retired.epoch)
+                ;
+
+            FreeRetired(clist, &retired);
+            return;
+        }
+
+        clist->retired         = (ListRetiredType*)tmpPtr;
+        clist->retiredCapacity = newCapacity;
+    }
+
+    clist->retired[clist->retiredCount++] = retired;
+}
+
+static void* ConcurrentAlloc(void* context, const size_t size, const size_t alignment)
+{
+    (void)context;
+    (void)alignment;
+
+    return malloc(size);
+}
+
+static void* ConcurrentRealloc(void* context, void* ptr, const size_t oldSize,
+                                                         const size_t newSize,
+                                                         const size_t alignment)
+{
+    assert(context);
+
+    ListConcurrentType* clist = (ListConcurrentType*)context;
+
+    void* newPtr = ConcurrentAlloc(context, newSize, alignment);
+
+    if (newPtr == nullptr)
+        return nullptr;
+
+    //readers may still traverse old array, it is kept until they leave
+    memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+    Retire(clist, 0, ptr, oldSize);
+
+    return newPtr;
+}
+
+static void ConcurrentFree(void* context, void* ptr, const size_t size)
+{
+    assert(context);
+
+    Retire((ListConcurrentType*)context, 0, ptr, size);
+}
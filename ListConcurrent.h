@@ -0,0 +1,78 @@
+#ifndef LIST_CONCURRENT_H
+#define LIST_CONCURRENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "List.h"
+
+/// \file
+/// \brief List with many concurrent readers and one writer, epoch based reclamation.
+/// \details Readers traverse without locks between ListConcurrentReadBegin and
+///          ListConcurrentReadEnd. Erased slots and data arrays replaced by growth are
+///          retired with current epoch and reused or freed only after every reader
+///          that could see them has left. All writer functions have to be called
+///          from one thread at a time.
+
+struct ListReaderEpochType
+{
+    alignas(64) std::atomic<uint64_t> epoch; ///< 0 if reader is outside of read section
+};
+
+struct ListRetiredType
+{
+    uint64_t epoch;
+
+    size_t pos;          ///< retired slot, used if data is nullptr
+    void*  data;         ///< retired data array
+    size_t dataSize;
+};
+
+struct ListConcurrentType
+{
+    ListType list;                          ///< writer side list
+
+    std::atomic<ListElemType*> data;        ///< data published for readers
+    std::atomic<uint64_t>      globalEpoch;
+
+    ListReaderEpochType* readers;
+    size_t               readersCapacity;
+    std::atomic<size_t>  readersCount;
+
+    ListRetiredType* retired;
+    size_t           retiredCount;
+    size_t           retiredCapacity;
+};
+
+ListErrors ListConcurrentCtor(ListConcurrentType* clist, const size_t maxReaders,
+                              const size_t capacity = 0);
+ListErrors ListConcurrentDtor(ListConcurrentType* clist);
+
+/// @brief Gives id for a new reader thread
+ListErrors ListConcurrentReaderRegister(ListConcurrentType* clist, size_t* readerId);
+
+//-------Reader side---------
+
+void   ListConcurrentReadBegin(ListConcurrentType* clist, const size_t readerId);
+void   ListConcurrentReadEnd  (ListConcurrentType* clist, const size_t readerId);
+
+size_t ListConcurrentGetHead     (ListConcurrentType* clist);
+size_t ListConcurrentGetTail     (ListConcurrentType* clist);
+size_t ListConcurrentGetNextElem (ListConcurrentType* clist, const size_t pos);
+size_t ListConcurrentGetPrevElem (ListConcurrentType* clist, const size_t pos);
+int    ListConcurrentGetElemValue(ListConcurrentType* clist, const size_t pos);
+
+//-------Writer side---------
+
+ListErrors ListConcurrentInsert(ListConcurrentType* clist, const size_t anchorPos,
+                                const int value, size_t* insertedValPos);
+ListErrors ListConcurrentErase (ListConcurrentType* clist, const size_t anchorPos);
+ListErrors ListConcurrentSetElemValue(ListConcurrentType* clist, const size_t pos,
+                                      const int newElemValue);
+
+/// @brief Frees retired slots and arrays no reader can see anymore
+void ListConcurrentReclaim(ListConcurrentType* clist);
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef LIST_FREE_CHAIN_H
+#define LIST_FREE_CHAIN_H
+
+#include <assert.h>
+
+/// \file
+/// \brief Chain of free slots shared by index linked lists.
+/// \details Free slots are doubly linked through prevPos and nextPos of their nodes,
+///          head has prevPos 0 and last slot has nextPos 0. Slot 0 is the end sentinel,
+///          it is never free, so 0 also means "no slot". Functions are templates on node
+///          and index types and are constexpr, so lists with static storage use them
+///          in constant expressions.
+
+/// @brief Chains slots of [begin, end) in physical order
+/// @return head of chain, 0 if range is empty
+template <typename NodeType, typename IndexType>
+constexpr IndexType ListFreeChainInit(NodeType* data, const IndexType begin, const IndexType end)
+{
+    assert(data);
+    assert(begin != 0);
+
+    if (begin >= end)
+        return 0;
+
+    IndexType prevPos = 0;
+
+    for (IndexType pos = begin; pos < end; ++pos)
+    {
+        data[pos].prevPos = prevPos;
+        data[pos].nextPos = pos;
+        ++data[pos].nextPos;
+
+        prevPos = pos;
+    }
+
+    data[prevPos].nextPos = 0;
+
+    return begin;
+}
+
+/// @brief Takes head slot of chain, chain must not be empty
+template <typename NodeType, typename IndexType>
+constexpr IndexType ListFreeChainPop(NodeType* data, IndexType* head)
+{
+    assert(data);
+    assert(head && *head != 0);
+
+    const IndexType pos = *head;
+
+    *head = data[pos].nextPos;
+
+    if (*head != 0)
+        data[*head].prevPos = 0;
+
+    return pos;
+}
+
+/// @brief Unlinks any free slot in O(1)
+template <typename NodeType, typename IndexType>
+constexpr void ListFreeChainRemove(NodeType* data, IndexType* head, const IndexType pos)
+{
+    assert(data);
+    assert(head);
+    assert(pos != 0);
+
+    const IndexType prevPos = data[pos].prevPos;
+    const IndexType nextPos = data[pos].nextPos;
+
+    if (prevPos == 0)
+        *head = nextPos;
+    else
+        data[prevPos].nextPos = nextPos;
+
+    if (nextPos != 0)
+        data[nextPos].prevPos = prevPos;
+}
+
+/// @brief Makes slot head of chain, it is reused first
+template <typename NodeType, typename IndexType>
+constexpr void ListFreeChainPush(NodeType* data, IndexType* head, const IndexType pos)
+{
+    assert(data);
+    assert(head);
+    assert(pos != 0);
+
+    data[pos].prevPos = 0;
+    data[pos].nextPos = *head;
+
+    if (*head != 0)
+        data[*head].prevPos = pos;
+
+    *head = pos;
+}
+
+#endif
@@ -0,0 +1,616 @@
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ListJournal.h"
+#include "ListBitmap.h"
+
+static const uint32_t JournalMagic    = 0x4C41574C; ///< "LWAL" in little endian file
+static const uint32_t SnapshotMagic   = 0x504E534C; ///< "LSNP" in little endian file
+static const uint32_t JournalVersion  = 1;
+
+static const char     TmpSuffix[]     = ".tmp";
+
+struct JournalHeaderType
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t epoch;     ///< journal belongs to snapshot with the same epoch
+};
+
+struct SnapshotHeaderType
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t epoch;     ///< new one on every ListJournalStart
+    uint64_t seq;       ///< journal records up to seq are in snapshot
+
+    uint64_t capacity;
+    uint64_t end;
+    uint64_t freeBlockHead;
+    uint64_t size;
+
+    uint32_t isLinear;
+    uint32_t allocPolicy;
+};
+
+static ListErrors JournalWrite   (ListJournalType* journal);
+static ListErrors JournalSync    (ListJournalType* journal);
+static ListErrors JournalTruncate(ListJournalType* journal);
+static void       JournalFree    (ListType* list);
+
+static ListErrors SnapshotSave(const ListType* list, const char* fileName,
+                               const uint64_t epoch, const uint64_t seq);
+static ListErrors SnapshotLoad(ListType* list, const char* fileName,
+                               const ListAllocatorType* allocator,
+                               uint64_t* epoch, uint64_t* seq);
+
+static ListErrors RecordApply (ListType* list, const ListJournalRecordType* record);
+
+static bool       WriteAll(const int fd, const void* data, size_t size, uint64_t offset);
+static ListErrors DirSync (const char* fileName);
+
+static inline uint64_t Checksum(uint64_t hash, const void* data, const size_t size);
+static inline uint64_t RecordChecksum(const ListJournalRecordType* record);
+static inline uint64_t NewEpoch();
+
+ListErrors ListJournalStart(ListType* list, const char* snapshotFileName,
+                                            const char* journalFileName,
+                            const size_t groupSize, const size_t checkpointRecords)
+{
+    assert(list);
+    assert(snapshotFileName);
+    assert(journalFileName);
+
+    ListJournalStop(list);
+
+    ListJournalType* journal = (ListJournalType*) list->allocator.allocFunc(
+                                                        list->allocator.context,
+                                                        sizeof(*journal),
+                                                        alignof(ListJournalType));
+
+    if (journal == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    memset(journal, 0, sizeof(*journal));
+
+    journal->groupSize         = groupSize         ? groupSize
+                                                   : ListJournalDefaultGroupSize;
+    journal->checkpointRecords = checkpointRecords ? checkpointRecords
+                                                   : ListJournalDefaultCheckpointRecords;
+    journal->epoch             = NewEpoch();
+    journal->status            = ListErrors::NO_ERR;
+
+    //journal is not truncated here: until new snapshot is in place old pair stays valid
+    journal->fd = open(journalFileName, O_RDWR | O_CREAT, 0644);
+
+    journal->buffer = (ListJournalRecordType*) list->allocator.allocFunc(
+                                            list->allocator.context,
+                                            journal->groupSize * sizeof(*journal->buffer),
+                                            alignof(ListJournalRecordType));
+
+    journal->snapshotFileName = strdup(snapshotFileName);
+    journal->journalFileName  = strdup(journalFileName);
+
+    list->journal = journal;
+
+    if (journal->buffer == nullptr || journal->snapshotFileName == nullptr ||
+                                      journal->journalFileName  == nullptr)
+    {
+        JournalFree(list);
+        return ListErrors::MEMORY_ERR;
+    }
+
+    if (journal->fd < 0)
+    {
+        JournalFree(list);
+        return ListErrors::FILE_ERR;
+    }
+
+    ListErrors error = ListJournalCheckpoint(list);
+
+    if (error != ListErrors::NO_ERR)
+    {
+        JournalFree(list);
+        return error;
+    }
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListJournalStop(ListType* list)
+{
+    assert(list);
+
+    if (list->journal == nullptr)
+        return ListErrors::NO_ERR;
+
+    ListErrors error = ListJournalCommit(list);
+
+    JournalFree(list);
+
+    return error;
+}
+
+ListErrors ListJournalCommit(ListType* list)
+{
+    assert(list);
+    assert(list->journal);
+
+    ListJournalType* journal = list->journal;
+
+    if (journal->status != ListErrors::NO_ERR)
+        return journal->status;
+
+    if (journal->bufferSize == 0)
+        return ListErrors::NO_ERR;
+
+    if ((journal->status = JournalWrite(journal)) != ListErrors::NO_ERR ||
+        (journal->status = JournalSync (journal)) != ListErrors::NO_ERR)
+        return journal->status;
+
+    journal->commitsCount++;
+
+    if (journal->seq - journal->checkpointSeq >= journal->checkpointRecords)
+        return ListJournalCheckpoint(list);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListJournalCheckpoint(ListType* list)
+{
+    assert(list);
+    assert(list->journal);
+
+    ListJournalType* journal = list->journal;
+
+    if (journal->status != ListErrors::NO_ERR)
+        return journal->status;
+
+    ListErrors error = SnapshotSave(list, journal->snapshotFileName,
+                                          journal->epoch, journal->seq);
+
+    //crash before truncation is harmless: epoch and seq of snapshot skip old records
+    if (error == ListErrors::NO_ERR)
+        error = JournalTruncate(journal);
+
+    if (error != ListErrors::NO_ERR)
+        return journal->status = error;
+
+    //buffered records are in snapshot already
+    journal->bufferSize    = 0;
+    journal->checkpointSeq = journal->seq;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListJournalRecover(ListType* list, const char* snapshotFileName,
+                                              const char* journalFileName,
+                              const ListAllocatorType* allocator, size_t* replayedCount)
+{
+    assert(list);
+    assert(snapshotFileName);
+    assert(journalFileName);
+
+    uint64_t epoch = 0;
+    uint64_t seq   = 0;
+
+    ListErrors error = SnapshotLoad(list, snapshotFileName, allocator, &epoch, &seq);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    size_t replayed = 0;
+
+    FILE* file = fopen(journalFileName, "rb");
+
+    JournalHeaderType header = {};
+
+    //missing journal or journal of other snapshot has nothing to repeat
+    if (file && fread(&header, sizeof(header), 1, file) == 1 &&
+        header.magic == JournalMagic &&
+        header.version == JournalVersion && header.epoch == epoch)
+    {
+        const ListVerifyLevel verifyLevel = list->verifyLevel;
+        list->verifyLevel = ListVerifyLevel::NONE;
+
+        ListJournalRecordType record = {};
+
+        //reading stops at torn or not committed tail
+        while (fread(&record, sizeof(record), 1, file) == 1 &&
+               record.checksum == RecordChecksum(&record))
+        {
+            if (record.seq <= seq)
+                continue;
+
+            if (record.seq != seq + 1)
+                break;
+
+            if ((error = RecordApply(list, &record)) != ListErrors::NO_ERR)
+                break;
+
+            seq++;
+            replayed++;
+        }
+
+        list->verifyLevel = verifyLevel;
+    }
+
+    if (file)
+        fclose(file);
+
+    if (error == ListErrors::NO_ERR)
+        error = ListVerify(list);
+
+    if (error != ListErrors::NO_ERR)
+    {
+        ListDtor(list);
+        return error;
+    }
+
+    if (replayedCount)
+        *replayedCount = replayed;
+
+    return ListErrors::NO_ERR;
+}
+
+void ListJournalRecord(ListType* list, const ListJournalOp op, const size_t pos,
+                       const size_t anchorPos, const int value)
+{
+    assert(list);
+    assert(list->journal);
+
+    ListJournalType* journal = list->journal;
+
+    if (journal->status != ListErrors::NO_ERR)
+        return;
+
+    ListJournalRecordType* record = &journal->buffer[journal->bufferSize++];
+
+    record->seq       = ++journal->seq;
+    record->pos       = pos;
+    record->anchorPos = anchorPos;
+    record->value     = value;
+    record->op        = (uint32_t)op;
+    record->checksum  = RecordChecksum(record);
+
+    if (journal->bufferSize == journal->groupSize)
+        ListJournalCommit(list);
+}
+
+static ListErrors JournalWrite(ListJournalType* journal)
+{
+    assert(journal);
+
+    const size_t size = journal->bufferSize * sizeof(*journal->buffer);
+
+    if (!WriteAll(journal->fd, journal->buffer, size, journal->fileSize))
+        return ListErrors::FILE_ERR;
+
+    journal->fileSize  += size;
+    journal->bufferSize = 0;
+
+    return ListErrors::NO_ERR;
+}
+
+static ListErrors JournalSync(ListJournalType* journal)
+{
+    assert(journal);
+
+    return fdatasync(journal->fd) == 0 ? ListErrors::NO_ERR : ListErrors::FILE_ERR;
+}
+
+static ListErrors JournalTruncate(ListJournalType* journal)
+{
+    assert(journal);
+
+    JournalHeaderType header = {};
+
+    header.magic   = JournalMagic;
+    header.version = JournalVersion;
+    header.epoch   = journal->epoch;
+
+    if (ftruncate(journal->fd, 0) != 0 || !WriteAll(journal->fd, &header, sizeof(header), 0))
+        return ListErrors::FILE_ERR;
+
+    journal->fileSize = sizeof(header);
+
+    return JournalSync(journal);
+}
+
+static void JournalFree(ListType* list)
+{
+    assert(list);
+    assert(list->journal);
+
+    ListJournalType* journal = list->journal;
+
+    if (journal->fd >= 0)
+        close(journal->fd);
+
+    if (journal->buffer)
+        list->allocator.freeFunc(list->allocator.context, journal->buffer,
+                                 journal->groupSize * sizeof(*journal->buffer));
+
+    free(journal->snapshotFileName);
+    free(journal->journalFileName);
+
+    list->allocator.freeFunc(list->allocator.context, journal, sizeof(*journal));
+    list->journal = nullptr;
+}
+
+static ListErrors SnapshotSave(const ListType* list, const char* fileName,
+                               const uint64_t epoch, const uint64_t seq)
+{
+    assert(list);
+    assert(fileName);
+
+    SnapshotHeaderType header = {};
+
+    header.magic         = SnapshotMagic;
+    header.version       = JournalVersion;
+    header.epoch         = epoch;
+    header.seq           = seq;
+    header.capacity      = list->capacity;
+    header.end           = list->end;
+    header.freeBlockHead = list->freeBlockHead;
+    header.size          = list->size;
+    header.isLinear      = list->isLinear;
+    header.allocPolicy   = (uint32_t)list->allocPolicy;
+
+    const size_t dataSize      = list->capacity * sizeof(*list->data);
+    const size_t occupancySize = ListBitmapWordsCount(list->capacity) * sizeof(*list->occupancy);
+
+    uint64_t checksum = Checksum(0,        &header,         sizeof(header));
+             checksum = Checksum(checksum, list->data,      dataSize);
+             checksum = Checksum(checksum, list->occupancy, occupancySize);
+
+    //snapshot is written aside and renamed, so old one is replaced atomically
+    const size_t tmpFileNameSize = strlen(fileName) + sizeof(TmpSuffix);
+    char* tmpFileName = (char*) calloc(tmpFileNameSize, sizeof(*tmpFileName));
+
+    if (tmpFileName == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    snprintf(tmpFileName, tmpFileNameSize, "%s%s", fileName, TmpSuffix);
+
+    FILE* file = fopen(tmpFileName, "wb");
+
+    bool isWritten = file != nullptr &&
+                     fwrite(&header,         sizeof(header),   1, file) == 1 &&
+                     fwrite(list->data,      dataSize,         1, file) == 1 &&
+                     fwrite(list->occupancy, occupancySize,    1, file) == 1 &&
+                     fwrite(&checksum,       sizeof(checksum), 1, file) == 1 &&
+                     fflush(file) == 0 && fdatasync(fileno(file)) == 0;
+
+    if (file && fclose(file) != 0)
+        isWritten = false;
+
+    isWritten = isWritten && rename(tmpFileName, fileName) == 0;
+
+    if (!isWritten)
+        remove(tmpFileName);
+
+    free(tmpFileName);
+
+    if (!isWritten)
+        return ListErrors::FILE_ERR;
+
+    return DirSync(fileName);
+}
+
+static ListErrors SnapshotLoad(ListType* list, const char* fileName,
+                               const ListAllocatorType* allocator,
+                               uint64_t* epoch, uint64_t* seq)
+{
+    assert(list);
+    assert(fileName);
+    assert(epoch);
+    assert(seq);
+
+    FILE* file = fopen(fileName, "rb");
+
+    if (file == nullptr)
+        return ListErrors::FILE_ERR;
+
+    SnapshotHeaderType header = {};
+
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != SnapshotMagic ||
+        header.version != JournalVersion)
+    {
+        fclose(file);
+        return ListErrors::INVALID_DATA;
+    }
+
+    ListErrors error = ListCtor(list, header.capacity, allocator);
+
+    if (error != ListErrors::NO_ERR)
+    {
+        fclose(file);
+        return error;
+    }
+
+    const size_t dataSize      = list->capacity * sizeof(*list->data);
+    const size_t occupancySize = ListBitmapWordsCount(list->capacity) * sizeof(*list->occupancy);
+
+    uint64_t savedChecksum = 0;
+
+    const bool isRead = list->capacity == header.capacity &&
+                        fread(list->data,      dataSize,              1, file) == 1 &&
+                        fread(list->occupancy, occupancySize,         1, file) == 1 &&
+                        fread(&savedChecksum,  sizeof(savedChecksum), 1, file) == 1;
+
+    fclose(file);
+
+    uint64_t checksum = Checksum(0,        &header,         sizeof(header));
+             checksum = Checksum(checksum, list->data,      dataSize);
+             checksum = Checksum(checksum, list->occupancy, occupancySize);
+
+    if (!isRead || checksum != savedChecksum)
+    {
+        ListDtor(list);
+        return ListErrors::INVALID_DATA;
+    }
+
+    list->end           = header.end;
+    list->freeBlockHead = header.freeBlockHead;
+    list->size          = header.size;
+    list->isLinear      = header.isLinear != 0;
+    list->allocPolicy   = (ListAllocPolicy)header.allocPolicy;
+
+    *epoch = header.epoch;
+    *seq   = header.seq;
+
+    return ListErrors::NO_ERR;
+}
+
+static ListErrors RecordApply(ListType* list, const ListJournalRecordType* record)
+{
+    assert(list);
+    assert(record);
+
+    //position of insert is checked after it, slot may be beyond capacity before it
+    if ((record->op != (uint32_t)ListJournalOp::INSERT && record->pos >= list->capacity) ||
+        record->anchorPos >= list->capacity)
+        return ListErrors::OUT_OF_RANGE;
+
+    const size_t pos       = record->pos;
+    const size_t anchorPos = record->anchorPos;
+
+    //list is in the same state as when record was made, so insert takes the same slot
+    size_t insertedPos = 0;
+    ListErrors error = ListErrors::NO_ERR;
+
+    switch ((ListJournalOp)record->op)
+    {
+        case ListJournalOp::INSERT:
+            error = ListInsert(list, anchorPos, record->value, &insertedPos);
+
+            if (error == ListErrors::NO_ERR && insertedPos != pos)
+                error = ListErrors::INVALID_DATA;
+            break;
+
+        case ListJournalOp::ERASE:
+            error = ListErase(list, pos);
+            break;
+
+        case ListJournalOp::DETACH:
+            error = ListDetach(list, pos);
+            break;
+
+        case ListJournalOp::RELEASE:
+            error = ListReleaseSlot(list, pos);
+            break;
+
+        case ListJournalOp::MOVE:
+            error = ListMoveBefore(list, pos, anchorPos);
+            break;
+
+        case ListJournalOp::SET:
+            error = ListSetElemValue(list, pos, record->value);
+            break;
+
+        case ListJournalOp::POLICY:
+            ListSetAllocPolicy(list, (ListAllocPolicy)record->value);
+            break;
+
+        default:
+            error = ListErrors::INVALID_DATA;
+            break;
+    }
+
+    return error;
+}
+
+static bool WriteAll(const int fd, const void* data, size_t size, uint64_t offset)
+{
+    assert(data);
+
+    const char* bytes = (const char*)data;
+
+    while (size != 0)
+    {
+        const ssize_t written = pwrite(fd, bytes, size, (off_t)offset);
+
+        if (written < 0)
+            return false;
+
+        bytes  += written;
+        size   -= (size_t)written;
+        offset += (uint64_t)written;
+    }
+
+    return true;
+}
+
+static ListErrors DirSync(const char* fileName)
+{
+    assert(fileName);
+
+    //rename is durable only after directory is synced
+    const char* slash = strrchr(fileName, '/');
+
+    char* dirName = slash ? strndup(fileName, (size_t)(slash - fileName) + 1) : strdup(".");
+
+    if (dirName == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    const int dirFd = open(dirName, O_RDONLY | O_DIRECTORY);
+
+    free(dirName);
+
+    if (dirFd < 0)
+        return ListErrors::FILE_ERR;
+
+    const bool isSynced = fsync(dirFd) == 0;
+
+    close(dirFd);
+
+    return isSynced ? ListErrors::NO_ERR : ListErrors::FILE_ERR;
+}
+
+/// @brief Word at a time FNV-1a like hash
+static inline uint64_t Checksum(uint64_t hash, const void* data, const size_t size)
+{
+    assert(data);
+
+    static const uint64_t Prime = 0x100000001b3;
+
+    const unsigned char* bytes = (const unsigned char*)data;
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word = 0;
+        memcpy(&word, bytes + i, sizeof(word));
+
+        hash = (hash ^ word) * Prime;
+        hash ^= hash >> 29;
+    }
+
+    for (; i < size; ++i)
+        hash = (hash ^ bytes[i]) * Prime;
+
+    return hash;
+}
+
+static inline uint64_t RecordChecksum(const ListJournalRecordType* record)
+{
+    assert(record);
+
+    return Checksum(~(uint64_t)0, record, offsetof(ListJournalRecordType, checksum));
+}
+
+static inline uint64_t NewEpoch()
+{
+    timespec now = {};
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return ((uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec) ^
+           ((uint64_t)getpid() << 48);
+}
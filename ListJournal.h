@@ -0,0 +1,100 @@
+#ifndef LIST_JOURNAL_H
+#define LIST_JOURNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "List.h"
+
+/// \file
+/// \brief Write-ahead journal making list changes survive crashes.
+/// \details List state is kept as snapshot file (raw slots, occupancy and header) and
+///          append-only journal of changes made after it. Every change of links or
+///          values is one fixed size record with sequence number and checksum. Records
+///          are group committed: they are written and fdatasync-ed once per groupSize
+///          records or on ListJournalCommit, so change is durable only after its group
+///          is committed. Recovery loads snapshot and repeats journal records on it,
+///          torn tail of journal is dropped. Checkpoint writes new snapshot atomically
+///          (temporary file and rename) and truncates journal, it is made every
+///          checkpointRecords records and after operations moving elements to other
+///          slots (sort, rebuild).
+
+enum class ListJournalOp : uint32_t
+{
+    INSERT = 1, ///< pos is new position, anchorPos is anchor
+    ERASE,
+    DETACH,
+    RELEASE,
+    MOVE,       ///< pos is moved before anchorPos
+    SET,
+    POLICY,     ///< value is new ListAllocPolicy, it decides slots of inserts
+};
+
+/// @brief On-disk record, five words without padding
+struct ListJournalRecordType
+{
+    uint64_t seq;       ///< records go one by one starting from 1 after snapshot
+    uint64_t pos;
+    uint64_t anchorPos;
+    int32_t  value;
+    uint32_t op;
+    uint64_t checksum;  ///< of all previous fields
+};
+
+static const size_t ListJournalDefaultGroupSize         = 64;
+static const size_t ListJournalDefaultCheckpointRecords = 1 << 20;
+
+struct ListJournalType
+{
+    int fd;
+
+    char* snapshotFileName;
+    char* journalFileName;
+
+    ListJournalRecordType* buffer;    ///< records of group not written yet
+    size_t                 bufferSize;
+    size_t                 groupSize;
+
+    uint64_t epoch;                   ///< pairs journal with its snapshot
+    uint64_t seq;                     ///< sequence number of last record
+    uint64_t fileSize;
+
+    size_t   checkpointRecords;
+    uint64_t checkpointSeq;           ///< sequence number saved in snapshot
+
+    uint64_t commitsCount;
+
+    ListErrors status;                ///< first failure of recording, kept till Stop
+};
+
+/// @brief Writes snapshot of list, empties journal and starts journaling list changes
+/// @param [in]groupSize records per fdatasync, 0 means default
+/// @param [in]checkpointRecords records between checkpoints, 0 means default
+ListErrors ListJournalStart(ListType* list, const char* snapshotFileName,
+                                            const char* journalFileName,
+                            const size_t groupSize         = 0,
+                            const size_t checkpointRecords = 0);
+
+/// @brief Commits recorded changes and stops journaling, called by ListDtor too
+ListErrors ListJournalStop(ListType* list);
+
+/// @brief Makes all recorded changes durable
+ListErrors ListJournalCommit(ListType* list);
+
+/// @brief Replaces snapshot with current list and truncates journal
+ListErrors ListJournalCheckpoint(ListType* list);
+
+/// @brief Builds not constructed list from snapshot and journal
+/// @details Journaling is not started, ListJournalStart with the same files continues it.
+/// @param [out]replayedCount number of journal records repeated, may be nullptr
+ListErrors ListJournalRecover(ListType* list, const char* snapshotFileName,
+                                              const char* journalFileName,
+                              const ListAllocatorType* allocator = nullptr,
+                              size_t* replayedCount = nullptr);
+
+//-------Called by list on its changes---------
+
+void ListJournalRecord(ListType* list, const ListJournalOp op, const size_t pos,
+                       const size_t anchorPos = 0, const int value = 0);
+
+#endif
@@ -0,0 +1,256 @@
+#include <assert.h>
+#include <string.h>
+
+#include "Log.h"
+#include "ListLru.h"
+#include "ListValueIndex.h"
+#include "ListBitmap.h"
+
+static inline void       Touch    (ListLruType* cache, const size_t pos);
+static        ListErrors EvictTail(ListLruType* cache, int* evictedKey);
+
+ListErrors ListLruCtor(ListLruType* cache, const size_t budget, const ListLruPolicy policy,
+                       const ListAllocatorType* allocator)
+{
+    assert(cache);
+    assert(budget != 0);
+
+    cache->values     = nullptr;
+    cache->referenced = nullptr;
+
+    cache->budget = budget;
+    cache->policy = policy;
+
+    cache->hits = cache->misses = cache->evictions = 0;
+
+    //one slot is end sentinel, so list never grows while it keeps budget entries
+    ListErrors error = ListCtor(&cache->list, budget + 1, allocator);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    ListType* list = &cache->list;
+
+    //full check walks every slot, it would make each Get and Put O(budget);
+    //ListLruVerify still checks whole list
+    ListSetVerifyLevel(list, ListVerifyLevel::HEADER);
+
+                                  error = ListValueIndexEnable (list);
+    if (error == ListErrors::NO_ERR)
+                                  error = ListValueIndexReserve(list, budget);
+
+    if (error != ListErrors::NO_ERR)
+    {
+        ListLruDtor(cache);
+        return error;
+    }
+
+    const size_t wordsCount = ListBitmapWordsCount(list->capacity);
+
+    cache->values     = (int*)      list->allocator.allocFunc(list->allocator.context,
+                                                              list->capacity * sizeof(int),
+                                                              alignof(int));
+    cache->referenced = (uint64_t*) list->allocator.allocFunc(list->allocator.context,
+                                                              wordsCount * sizeof(uint64_t),
+                                                              alignof(uint64_t));
+
+    if (cache->values == nullptr || cache->referenced == nullptr)
+    {
+        ListLruDtor(cache);
+        return ListErrors::MEMORY_ERR;
+    }
+
+    memset(cache->referenced, 0, wordsCount * sizeof(uint64_t));
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListLruDtor(ListLruType* cache)
+{
+    assert(cache);
+
+    ListType* list = &cache->list;
+
+    if (cache->values != nullptr)
+        list->allocator.freeFunc(list->allocator.context, cache->values,
+                                 list->capacity * sizeof(int));
+
+    if (cache->referenced != nullptr)
+        list->allocator.freeFunc(list->allocator.context, cache->referenced,
+                                 ListBitmapWordsCount(list->capacity) * sizeof(uint64_t));
+
+    cache->values     = nullptr;
+    cache->referenced = nullptr;
+    cache->budget     = 0;
+
+    return ListDtor(list);
+}
+
+ListErrors ListLruVerify(ListLruType* cache)
+{
+    assert(cache);
+
+    if (cache->values == nullptr || cache->referenced == nullptr)
+        return ListErrors::DATA_IS_NULLPTR;
+
+    if (cache->list.valueIndex == nullptr)
+        return ListErrors::INVALID_NULLPTR;
+
+    if (cache->list.size > cache->budget || cache->list.capacity <= cache->budget)
+        return ListErrors::OUT_OF_RANGE;
+
+    return ListVerify(&cache->list);
+}
+
+ListErrors ListLruGet(ListLruType* cache, const int key, int* value)
+{
+    assert(cache);
+    assert(value);
+
+    size_t pos = 0;
+    ListErrors error = ListFind(&cache->list, key, &pos);
+
+    if (error == ListErrors::VALUE_NOT_FOUND)
+    {
+        cache->misses++;
+        return error;
+    }
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    cache->hits++;
+
+    *value = cache->values[pos];
+    Touch(cache, pos);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListLruPut(ListLruType* cache, const int key, const int value,
+                      int* evictedKey, bool* isEvicted)
+{
+    assert(cache);
+
+    ListType* list = &cache->list;
+
+    if (isEvicted)
+        *isEvicted = false;
+
+    size_t pos = 0;
+    ListErrors error = ListFind(list, key, &pos);
+
+    if (error == ListErrors::NO_ERR)
+    {
+        cache->values[pos] = value;
+        Touch(cache, pos);
+
+        return ListErrors::NO_ERR;
+    }
+
+    if (error != ListErrors::VALUE_NOT_FOUND)
+        return error;
+
+    if (list->size == cache->budget)
+    {
+        int victimKey = 0;
+        error = EvictTail(cache, &victimKey);
+
+        if (error != ListErrors::NO_ERR)
+            return error;
+
+        if (evictedKey)
+            *evictedKey = victimKey;
+        if (isEvicted)
+            *isEvicted  = true;
+    }
+
+    //slot of evicted entry is head of free blocks, it is taken again without allocation
+    error = ListInsert(list, ListGetHead(list), key, &pos);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    cache->values[pos] = value;
+    ListBitmapClear(cache->referenced, pos);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListLruErase(ListLruType* cache, const int key)
+{
+    assert(cache);
+
+    size_t pos = 0;
+    ListErrors error = ListFind(&cache->list, key, &pos);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    return ListErase(&cache->list, pos);
+}
+
+size_t ListLruGetSize(const ListLruType* cache)
+{
+    assert(cache);
+
+    return cache->list.size;
+}
+
+void ListLruStatsDump(const ListLruType* cache)
+{
+    assert(cache);
+
+    LOG_BEGIN();
+
+    Log("Cache %s, entries: %zu of %zu\n", cache->policy == ListLruPolicy::LRU ? "LRU" : "CLOCK",
+        cache->list.size, cache->budget);
+    Log("\tHits: %llu, misses: %llu, evictions: %llu\n",
+        (unsigned long long)cache->hits, (unsigned long long)cache->misses,
+        (unsigned long long)cache->evictions);
+
+    LOG_END();
+}
+
+static inline void Touch(ListLruType* cache, const size_t pos)
+{
+    assert(cache);
+
+    if (cache->policy == ListLruPolicy::CLOCK)
+    {
+        ListBitmapSet(cache->referenced, pos);
+        return;
+    }
+
+    ListMoveBefore(&cache->list, pos, ListGetHead(&cache->list));
+}
+
+static ListErrors EvictTail(ListLruType* cache, int* evictedKey)
+{
+    assert(cache);
+    assert(evictedKey);
+
+    ListType* list = &cache->list;
+    assert(list->size != 0);
+
+    size_t victim = ListGetTail(list);
+
+    //second chance: referenced entries go to front with bit cleared, so loop ends
+    while (ListBitmapTest(cache->referenced, victim))
+    {
+        ListBitmapClear(cache->referenced, victim);
+
+        ListErrors error = ListMoveBefore(list, victim, ListGetHead(list));
+
+        if (error != ListErrors::NO_ERR)
+            return error;
+
+        victim = ListGetTail(list);
+    }
+
+    *evictedKey = list->data[victim].value;
+
+    cache->evictions++;
+
+    return ListErase(list, victim);
+}
@@ -0,0 +1,62 @@
+#ifndef LIST_LRU_H
+#define LIST_LRU_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "List.h"
+
+/// \file
+/// \brief Fixed size cache of int keys and values with LRU or CLOCK eviction.
+/// \details Keys are element values of recency list, head is the most recent entry.
+///          Key table is value index of the list: open addressing table of slot
+///          indices. Cached values and CLOCK reference bits are arrays indexed by slot.
+///          All memory is taken in constructor, Get and Put never allocate. List checks
+///          only its header on operations, ListLruVerify makes full check.
+
+enum class ListLruPolicy
+{
+    LRU,    ///< hit moves entry to front
+    CLOCK,  ///< hit only sets reference bit, referenced tail gets second chance on eviction
+};
+
+struct ListLruType
+{
+    ListType list;
+
+    int*      values;     ///< cached value of every slot of list
+    uint64_t* referenced; ///< CLOCK reference bit of every slot of list
+
+    size_t        budget; ///< max number of entries
+    ListLruPolicy policy;
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+};
+
+/// @brief Creates cache of at most budget entries
+ListErrors ListLruCtor  (ListLruType* cache, const size_t budget,
+                         const ListLruPolicy policy = ListLruPolicy::LRU,
+                         const ListAllocatorType* allocator = nullptr);
+ListErrors ListLruDtor  (ListLruType* cache);
+ListErrors ListLruVerify(ListLruType* cache);
+
+/// @brief Looks key up and marks it as recently used
+/// @return VALUE_NOT_FOUND on miss
+ListErrors ListLruGet  (ListLruType* cache, const int key, int* value);
+
+/// @brief Adds or updates entry, least recently used one is evicted if cache is full
+/// @param [out]evictedKey key of evicted entry (may be nullptr)
+/// @param [out]isEvicted  true if some entry was evicted (may be nullptr)
+ListErrors ListLruPut  (ListLruType* cache, const int key, const int value,
+                        int* evictedKey = nullptr, bool* isEvicted = nullptr);
+
+/// @brief Removes entry, VALUE_NOT_FOUND if there is no such key
+ListErrors ListLruErase(ListLruType* cache, const int key);
+
+size_t ListLruGetSize(const ListLruType* cache);
+
+void ListLruStatsDump(const ListLruType* cache);
+
+#endif
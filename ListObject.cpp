@@ -0,0 +1,203 @@
+#include <assert.h>
+#include <string.h>
+
+#include <new>
+
+#include "ListObject.h"
+#include "ListJournal.h"
+#include "ListOrderIndex.h"
+#include "ListValueIndex.h"
+
+ListObject::ListObject(const size_t capacity) :
+    list_(), inlineData_(), inlineBitmap_(), inlineDataUsed_(false), inlineBitmapUsed_(false)
+{
+    Construct(capacity);
+}
+
+ListObject::~ListObject()
+{
+    ListDtor(&list_);
+}
+
+ListObject::ListObject(const ListObject& other) :
+    list_(), inlineData_(), inlineBitmap_(), inlineDataUsed_(false), inlineBitmapUsed_(false)
+{
+    CopyFrom(other);
+}
+
+ListObject::ListObject(ListObject&& other) noexcept :
+    list_(), inlineData_(), inlineBitmap_(), inlineDataUsed_(false), inlineBitmapUsed_(false)
+{
+    StealFrom(other);
+}
+
+ListObject& ListObject::operator=(const ListObject& other)
+{
+    if (this == &other)
+        return *this;
+
+    //copy is made first, so this is unchanged if it throws
+    ListObject copy(other);
+
+    return *this = static_cast<ListObject&&>(copy);
+}
+
+ListObject& ListObject::operator=(ListObject&& other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    ListDtor(&list_);
+    StealFrom(other);
+
+    return *this;
+}
+
+bool ListObject::IsInline() const
+{
+    return list_.data == (const ListElemType*)(const void*)inlineData_;
+}
+
+void ListObject::Construct(const size_t capacity)
+{
+    const ListAllocatorType allocator = GetAllocator();
+
+    if (ListCtor(&list_, capacity, &allocator) != ListErrors::NO_ERR)
+        throw std::bad_alloc();
+}
+
+void ListObject::CopyFrom(const ListObject& other)
+{
+    const ListAllocatorType allocator = GetAllocator();
+
+    if (ListCopy(&other.list_, &list_, &allocator) != ListErrors::NO_ERR)
+        throw std::bad_alloc();
+}
+
+void ListObject::StealFrom(ListObject& other) noexcept
+{
+    list_ = other.list_;
+    list_.allocator.context = this;
+
+    //heap blocks are just taken, inline blocks are copied and pointers to them moved
+    inlineDataUsed_   = other.inlineDataUsed_;
+    inlineBitmapUsed_ = other.inlineBitmapUsed_;
+
+    if (inlineDataUsed_)
+        memcpy(inlineData_, other.inlineData_, sizeof(inlineData_));
+    if (inlineBitmapUsed_)
+        memcpy(inlineBitmap_, other.inlineBitmap_, sizeof(inlineBitmap_));
+
+    Rebase(&list_.data,       other);
+    Rebase(&list_.occupancy,  other);
+    Rebase(&list_.orderIndex, other);
+    Rebase(&list_.valueIndex, other);
+    Rebase(&list_.trace,      other);
+    Rebase(&list_.journal,    other);
+
+    if (list_.orderIndex)
+        Rebase(&list_.orderIndex->nodes,   other);
+    if (list_.valueIndex)
+        Rebase(&list_.valueIndex->entries, other);
+    if (list_.journal)
+        Rebase(&list_.journal->buffer,     other);
+
+    //other is left empty, its destructor does nothing
+    memset(&other.list_, 0, sizeof(other.list_));
+    other.inlineDataUsed_   = false;
+    other.inlineBitmapUsed_ = false;
+}
+
+template <typename T>
+void ListObject::Rebase(T** ptr, const ListObject& other) noexcept
+{
+    assert(ptr);
+
+    const char* address = (const char*)*ptr;
+
+    const char* otherBegin = (const char*)&other;
+    const char* otherEnd   = otherBegin + sizeof(other);
+
+    if (address < otherBegin || address >= otherEnd)
+        return;
+
+    *ptr = (T*)(void*)((char*)this + (address - otherBegin));
+}
+
+ListAllocatorType ListObject::GetAllocator()
+{
+    return { InlineAlloc, InlineRealloc, InlineFree, this };
+}
+
+void* ListObject::InlineAlloc(void* context, const size_t size, const size_t alignment)
+{
+    assert(context);
+
+    ListObject* object = (ListObject*)context;
+
+    if (size <= sizeof(object->inlineBitmap_) && alignment <= alignof(uint64_t) &&
+        !object->inlineBitmapUsed_)
+    {
+        object->inlineBitmapUsed_ = true;
+        return object->inlineBitmap_;
+    }
+
+    if (size <= sizeof(object->inlineData_) && alignment <= alignof(ListElemType) &&
+        !object->inlineDataUsed_)
+    {
+        object->inlineDataUsed_ = true;
+        return object->inlineData_;
+    }
+
+    const ListAllocatorType heap = ListStandardAllocator();
+    return heap.allocFunc(heap.context, size, alignment);
+}
+
+void* ListObject::InlineRealloc(void* context, void* ptr, const size_t oldSize,
+                                                          const size_t newSize,
+                                                          const size_t alignment)
+{
+    assert(context);
+
+    ListObject* object = (ListObject*)context;
+
+    const bool isInlineData   = ptr == object->inlineData_;
+    const bool isInlineBitmap = ptr == object->inlineBitmap_;
+
+    const ListAllocatorType heap = ListStandardAllocator();
+
+    if (!isInlineData && !isInlineBitmap)
+        return ptr == nullptr ? InlineAlloc(context, newSize, alignment)
+                              : heap.reallocFunc(heap.context, ptr, oldSize, newSize, alignment);
+
+    if (newSize <= (isInlineData ? sizeof(object->inlineData_) : sizeof(object->inlineBitmap_)))
+        return ptr;
+
+    //list outgrows inline block, it moves to heap and block becomes free
+    void* newPtr = heap.allocFunc(heap.context, newSize, alignment);
+
+    if (newPtr == nullptr)
+        return nullptr;
+
+    memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+    InlineFree(context, ptr, oldSize);
+
+    return newPtr;
+}
+
+void ListObject::InlineFree(void* context, void* ptr, const size_t size)
+{
+    assert(context);
+
+    ListObject* object = (ListObject*)context;
+
+    if (ptr == object->inlineData_)
+        object->inlineDataUsed_ = false;
+    else if (ptr == object->inlineBitmap_)
+        object->inlineBitmapUsed_ = false;
+    else
+    {
+        const ListAllocatorType heap = ListStandardAllocator();
+        heap.freeFunc(heap.context, ptr, size);
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef LIST_OBJECT_H
+#define LIST_OBJECT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "List.h"
+#include "ListBitmap.h"
+
+/// \file
+/// \brief Owning C++ wrapper of ListType.
+/// \details Destructor frees list, copy is deep, move steals storage and never throws.
+///          Storage of up to ListObjectInlineCapacity nodes lives inside the object,
+///          it is given by allocator whose context is the object, so tiny lists do
+///          not allocate at all. Constructors throw std::bad_alloc, other methods
+///          return ListErrors as C functions do.
+
+static const size_t ListObjectInlineCapacity = 16;
+
+class ListObject
+{
+  public:
+    explicit ListObject(const size_t capacity = 0);
+    ~ListObject();
+
+    ListObject(const ListObject& other);
+    ListObject(ListObject&& other) noexcept;
+
+    ListObject& operator=(const ListObject& other);
+    ListObject& operator=(ListObject&& other) noexcept;
+
+    ListType*       Get()       { return &list_; }
+    const ListType* Get() const { return &list_; }
+
+    size_t GetSize()     const { return list_.size;     }
+    size_t GetCapacity() const { return list_.capacity; }
+    size_t GetEnd()      const { return list_.end;      }
+    size_t GetHead()     const { return ListGetHead(&list_); }
+    size_t GetTail()     const { return ListGetTail(&list_); }
+
+    /// @brief True if storage of list is inside the object
+    bool IsInline() const;
+
+    ListErrors Insert(const size_t anchorPos, const int value, size_t* insertedValPos)
+    {
+        return ListInsert(&list_, anchorPos, value, insertedValPos);
+    }
+
+    ListErrors PushBack(const int value, size_t* insertedValPos)
+    {
+        return ListInsert(&list_, list_.end, value, insertedValPos);
+    }
+
+    ListErrors Erase(const size_t pos) { return ListErase(&list_, pos); }
+
+    ListErrors GetNextElem (const size_t pos, size_t* nextPos)
+    {
+        return ListGetNextElem(&list_, pos, nextPos);
+    }
+    ListErrors GetPrevElem (const size_t pos, size_t* prevPos)
+    {
+        return ListGetPrevElem(&list_, pos, prevPos);
+    }
+    ListErrors GetElemValue(const size_t pos, int* value)
+    {
+        return ListGetElemValue(&list_, pos, value);
+    }
+    ListErrors SetElemValue(const size_t pos, const int value)
+    {
+        return ListSetElemValue(&list_, pos, value);
+    }
+
+  private:
+    static void* InlineAlloc  (void* context, const size_t size, const size_t alignment);
+    static void* InlineRealloc(void* context, void* ptr, const size_t oldSize,
+                                                         const size_t newSize,
+                                                         const size_t alignment);
+    static void  InlineFree   (void* context, void* ptr, const size_t size);
+
+    ListAllocatorType GetAllocator();
+
+    void Construct(const size_t capacity);
+    void CopyFrom (const ListObject& other);
+    void StealFrom(ListObject& other) noexcept;
+
+    /// @brief Moves pointer into inline storage of other to the same place of this
+    template <typename T>
+    void Rebase(T** ptr, const ListObject& other) noexcept;
+
+    ListType list_;
+
+    //-----inline storage: one block for nodes and one for occupancy bitmap-----
+
+    alignas(ListElemType) unsigned char inlineData_[ListObjectInlineCapacity *
+                                                    sizeof(ListElemType)];
+    uint64_t inlineBitmap_[(ListObjectInlineCapacity + ListBitmapWordBits - 1) /
+                           ListBitmapWordBits];
+
+    bool inlineDataUsed_;
+    bool inlineBitmapUsed_;
+};
+
+#endif
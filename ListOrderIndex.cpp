@@ -0,0 +1,445 @@
+#include <assert.h>
+#include <string.h>
+
+#include "ListOrderIndex.h"
+
+static inline size_t&   Left    (ListOrderIndexType* index, const size_t node);
+static inline size_t&   Right   (ListOrderIndexType* index, const size_t node);
+static inline size_t&   Parent  (ListOrderIndexType* index, const size_t node);
+static inline size_t    Size    (ListOrderIndexType* index, const size_t node);
+static inline uint32_t  Priority(ListOrderIndexType* index, const size_t node);
+static inline void      Update  (ListOrderIndexType* index, const size_t node);
+
+static inline void     NodeInit      (ListOrderIndexType* index, const size_t node);
+static inline uint32_t GenerateRandom(ListOrderIndexType* index);
+
+static void   Split(ListOrderIndexType* index, const size_t node, const size_t count,
+                                               size_t* leftTree, size_t* rightTree);
+static size_t Merge(ListOrderIndexType* index, const size_t leftTree, const size_t rightTree);
+
+static void   CountSubtreeSizes(ListOrderIndexType* index);
+
+static size_t WalkToIndex(const ListType* list, size_t index);
+static size_t WalkToPos  (const ListType* list, const size_t pos);
+
+ListErrors ListOrderIndexEnable(ListType* list)
+{
+    assert(list);
+
+    if (list->orderIndex != nullptr)
+        return ListErrors::NO_ERR;
+
+    ListOrderIndexType* index = (ListOrderIndexType*) list->allocator.allocFunc(
+                                                            list->allocator.context,
+                                                            sizeof(*index),
+                                                            alignof(ListOrderIndexType));
+
+    if (index == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    index->nodes       = nullptr;
+    index->capacity    = 0;
+    index->root        = 0;
+    index->randomState = 0x9E3779B97F4A7C15ull;
+
+    list->orderIndex = index;
+
+    ListErrors error = ListOrderIndexRebuild(list);
+
+    if (error != ListErrors::NO_ERR)
+        ListOrderIndexDisable(list);
+
+    return error;
+}
+
+ListErrors ListOrderIndexDisable(ListType* list)
+{
+    assert(list);
+
+    ListOrderIndexType* index = list->orderIndex;
+
+    if (index == nullptr)
+        return ListErrors::NO_ERR;
+
+    if (index->nodes != nullptr)
+        list->allocator.freeFunc(list->allocator.context, index->nodes,
+                                 index->capacity * sizeof(*index->nodes));
+
+    list->allocator.freeFunc(list->allocator.context, index, sizeof(*index));
+
+    list->orderIndex = nullptr;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListGetByIndex(ListType* list, const size_t elemIndex, size_t* pos)
+{
+    assert(list);
+    assert(pos);
+
+    if (elemIndex >= list->size)
+        return ListErrors::OUT_OF_RANGE;
+
+    ListOrderIndexType* index = list->orderIndex;
+
+    if (index == nullptr)
+    {
+        *pos = WalkToIndex(list, elemIndex);
+        return ListErrors::NO_ERR;
+    }
+
+    size_t node      = index->root;
+    size_t restIndex = elemIndex;
+
+    while (node != 0)
+    {
+        const size_t leftSize = Size(index, Left(index, node));
+
+        if (restIndex == leftSize)
+            break;
+
+        if (restIndex < leftSize)
+            node = Left(index, node);
+        else
+        {
+            restIndex -= leftSize + 1;
+            node = Right(index, node);
+        }
+    }
+
+    assert(node != 0);
+
+    *pos = node;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListIndexOf(ListType* list, const size_t pos, size_t* elemIndex)
+{
+    assert(list);
+    assert(elemIndex);
+
+    if (pos == list->end || pos >= list->capacity)
+        return ListErrors::OUT_OF_RANGE;
+
+    ListOrderIndexType* index = list->orderIndex;
+
+    if (index == nullptr)
+    {
+        *elemIndex = WalkToPos(list, pos);
+        return ListErrors::NO_ERR;
+    }
+
+    size_t rank = Size(index, Left(index, pos));
+
+    for (size_t node = pos; Parent(index, node) != 0; node = Parent(index, node))
+    {
+        const size_t parent = Parent(index, node);
+
+        if (Right(index, parent) == node)
+            rank += Size(index, Left(index, parent)) + 1;
+    }
+
+    *elemIndex = rank;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListOrderIndexReserve(ListType* list, const size_t capacity)
+{
+    assert(list);
+
+    ListOrderIndexType* index = list->orderIndex;
+    assert(index);
+
+    if (capacity <= index->capacity)
+        return ListErrors::NO_ERR;
+
+    void* tmpPtr = list->allocator.reallocFunc(list->allocator.context, index->nodes,
+                                               index->capacity * sizeof(*index->nodes),
+                                               capacity        * sizeof(*index->nodes),
+                                               alignof(ListOrderNodeType));
+
+    if (tmpPtr == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    index->nodes = (ListOrderNodeType*)tmpPtr;
+
+    if (index->capacity == 0)
+        memset(&index->nodes[0], 0, sizeof(*index->nodes));
+
+    index->capacity = capacity;
+
+    return ListErrors::NO_ERR;
+}
+
+void ListOrderIndexOnInsert(ListType* list, const size_t pos, const size_t anchorPos)
+{
+    assert(list);
+
+    ListOrderIndexType* index = list->orderIndex;
+    assert(index);
+    assert(pos < index->capacity);
+
+    size_t rank = Size(index, index->root);
+
+    if (anchorPos != list->end)
+        ListIndexOf(list, anchorPos, &rank);
+
+    NodeInit(index, pos);
+
+    size_t leftTree  = 0;
+    size_t rightTree = 0;
+    Split(index, index->root, rank, &leftTree, &rightTree);
+
+    index->root = Merge(index, Merge(index, leftTree, pos), rightTree);
+    Parent(index, index->root) = 0;
+}
+
+void ListOrderIndexOnErase(ListType* list, const size_t pos)
+{
+    assert(list);
+
+    ListOrderIndexType* index = list->orderIndex;
+    assert(index);
+    assert(pos != 0 && pos < index->capacity);
+
+    const size_t parent   = Parent(index, pos);
+    const size_t children = Merge(index, Left(index, pos), Right(index, pos));
+
+    if (children != 0)
+        Parent(index, children) = parent;
+
+    if (parent == 0)
+    {
+        index->root = children;
+        return;
+    }
+
+    if (Left(index, parent) == pos)
+        Left(index, parent)  = children;
+    else
+        Right(index, parent) = children;
+
+    for (size_t node = parent; node != 0; node = Parent(index, node))
+        index->nodes[node].subtreeSize--;
+}
+
+ListErrors ListOrderIndexRebuild(ListType* list)
+{
+    assert(list);
+
+    ListOrderIndexType* index = list->orderIndex;
+    assert(index);
+
+    ListErrors error = ListOrderIndexReserve(list, list->capacity);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    //-----Cartesian tree by priorities, built in list order along right spine-----
+
+    index->root = 0;
+    size_t rightmost = 0;
+
+    for (size_t pos = ListGetHead(list); pos != list->end; pos = list->data[pos].nextPos)
+    {
+        NodeInit(index, pos);
+
+        size_t node      = rightmost;
+        size_t lastChild = 0;
+
+        while (node != 0 && Priority(index, node) < Priority(index, pos))
+        {
+            lastChild = node;
+            node      = Parent(index, node);
+        }
+
+        Left(index, pos) = lastChild;
+        if (lastChild != 0)
+            Parent(index, lastChild) = pos;
+
+        Parent(index, pos) = node;
+        if (node != 0)
+            Right(index, node) = pos;
+        else
+            index->root = pos;
+
+        rightmost = pos;
+    }
+
+    CountSubtreeSizes(index);
+
+    return ListErrors::NO_ERR;
+}
+
+static void CountSubtreeSizes(ListOrderIndexType* index)
+{
+    assert(index);
+
+    //post-order traversal following parent links, no stack is needed
+    size_t node     = index->root;
+    size_t prevNode = 0;
+
+    while (node != 0)
+    {
+        size_t nextNode = Parent(index, node);
+
+        if (prevNode == Parent(index, node) && Left(index, node) != 0)
+            nextNode = Left(index, node);
+        else if (prevNode != Right(index, node) && Right(index, node) != 0)
+            nextNode = Right(index, node);
+        else
+            Update(index, node);
+
+        prevNode = node;
+        node     = nextNode;
+    }
+}
+
+static void Split(ListOrderIndexType* index, const size_t node, const size_t count,
+                                             size_t* leftTree, size_t* rightTree)
+{
+    assert(index);
+    assert(leftTree);
+    assert(rightTree);
+
+    if (node == 0)
+    {
+        *leftTree = *rightTree = 0;
+        return;
+    }
+
+    const size_t leftSize = Size(index, Left(index, node));
+
+    if (leftSize < count)
+    {
+        size_t splitLeft = 0;
+        Split(index, Right(index, node), count - leftSize - 1, &splitLeft, rightTree);
+
+        Right(index, node) = splitLeft;
+        if (splitLeft != 0)
+            Parent(index, splitLeft) = node;
+
+        *leftTree = node;
+    }
+    else
+    {
+        size_t splitRight = 0;
+        Split(index, Left(index, node), count, leftTree, &splitRight);
+
+        Left(index, node) = splitRight;
+        if (splitRight != 0)
+            Parent(index, splitRight) = node;
+
+        *rightTree = node;
+    }
+
+    Update(index, node);
+}
+
+static size_t Merge(ListOrderIndexType* index, const size_t leftTree, const size_t rightTree)
+{
+    assert(index);
+
+    if (leftTree  == 0)
+        return rightTree;
+    if (rightTree == 0)
+        return leftTree;
+
+    if (Priority(index, leftTree) > Priority(index, rightTree))
+    {
+        const size_t merged = Merge(index, Right(index, leftTree), rightTree);
+
+        Right(index, leftTree)  = merged;
+        Parent(index, merged)   = leftTree;
+
+        Update(index, leftTree);
+        return leftTree;
+    }
+
+    const size_t merged = Merge(index, leftTree, Left(index, rightTree));
+
+    Left(index, rightTree) = merged;
+    Parent(index, merged)  = rightTree;
+
+    Update(index, rightTree);
+    return rightTree;
+}
+
+static inline size_t& Left(ListOrderIndexType* index, const size_t node)
+{
+    return index->nodes[node].left;
+}
+
+static inline size_t& Right(ListOrderIndexType* index, const size_t node)
+{
+    return index->nodes[node].right;
+}
+
+static inline size_t& Parent(ListOrderIndexType* index, const size_t node)
+{
+    return index->nodes[node].parent;
+}
+
+static inline size_t Size(ListOrderIndexType* index, const size_t node)
+{
+    return node == 0 ? 0 : index->nodes[node].subtreeSize;
+}
+
+static inline uint32_t Priority(ListOrderIndexType* index, const size_t node)
+{
+    return index->nodes[node].priority;
+}
+
+static inline void Update(ListOrderIndexType* index, const size_t node)
+{
+    assert(node != 0);
+
+    index->nodes[node].subtreeSize = 1 + Size(index, Left (index, node))
+                                       + Size(index, Right(index, node));
+}
+
+static inline void NodeInit(ListOrderIndexType* index, const size_t node)
+{
+    assert(index);
+    assert(node != 0);
+
+    index->nodes[node].left        = 0;
+    index->nodes[node].right       = 0;
+    index->nodes[node].parent      = 0;
+    index->nodes[node].subtreeSize = 1;
+    index->nodes[node].priority    = GenerateRandom(index);
+}
+
+static inline uint32_t GenerateRandom(ListOrderIndexType* index)
+{
+    //xorshift64*
+    index->randomState ^= index->randomState >> 12;
+    index->randomState ^= index->randomState << 25;
+    index->randomState ^= index->randomState >> 27;
+
+    return (uint32_t)((index->randomState * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+static size_t WalkToIndex(const ListType* list, size_t index)
+{
+    assert(list);
+
+    size_t pos = ListGetHead(list);
+    for (; index != 0; --index)
+        pos = list->data[pos].nextPos;
+
+    return pos;
+}
+
+static size_t WalkToPos(const ListType* list, const size_t pos)
+{
+    assert(list);
+
+    size_t index = 0;
+    for (size_t i = ListGetHead(list); i != pos && i != list->end; i = list->data[i].nextPos)
+        ++index;
+
+    return index;
+}
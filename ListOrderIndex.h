@@ -0,0 +1,61 @@
+#ifndef LIST_ORDER_INDEX_H
+#define LIST_ORDER_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "List.h"
+
+/// \file
+/// \brief Optional order statistic layer over list.
+/// \details Implicit treap keyed by logical index whose nodes are list slots.
+///          Parent links let ListIndexOf climb from a slot to the root.
+///          Maintained by List.cpp on every change of list order,
+///          costs O(log n) per insert and erase.
+
+struct ListOrderNodeType
+{
+    size_t left;
+    size_t right;
+    size_t parent;
+
+    size_t   subtreeSize;
+    uint32_t priority;
+};
+
+struct ListOrderIndexType
+{
+    ListOrderNodeType* nodes;    ///< one node per list slot, 0 is null
+    size_t             capacity;
+
+    size_t root;
+
+    uint64_t randomState;
+};
+
+ListErrors ListOrderIndexEnable (ListType* list);
+ListErrors ListOrderIndexDisable(ListType* list);
+
+/// @brief Finds position of element with logical index (0 is head)
+/// @details O(log n) with order index, walks the list without it
+ListErrors ListGetByIndex(ListType* list, const size_t index, size_t* pos);
+
+/// @brief Finds logical index of element at pos
+/// @details O(log n) with order index, walks the list without it
+ListErrors ListIndexOf   (ListType* list, const size_t pos, size_t* index);
+
+//-------Called by list on its changes---------
+
+/// @brief Makes index able to keep capacity slots, called before list grows
+ListErrors ListOrderIndexReserve (ListType* list, const size_t capacity);
+
+/// @brief Adds element already linked before anchorPos
+void       ListOrderIndexOnInsert(ListType* list, const size_t pos, const size_t anchorPos);
+
+/// @brief Removes element, called before it is unlinked
+void       ListOrderIndexOnErase (ListType* list, const size_t pos);
+
+/// @brief Builds index again after positions of many elements changed
+ListErrors ListOrderIndexRebuild (ListType* list);
+
+#endif
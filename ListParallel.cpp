@@ -0,0 +1,516 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "ListParallel.h"
+#include "ListBitmap.h"
+
+static const size_t SublistsPerThread = 8;
+static const size_t ParallelMinSize   = 1 << 12;
+static const size_t NoSublist         = SIZE_MAX;
+static const int    POISON            = 0xDEAD;
+
+/// \brief Result of list ranking: rank of element pos is
+///        offset[sublistOf[pos]] + localRank[pos]
+struct ListRankingType
+{
+    size_t* sublistOf;      ///< capacity elements, NoSublist for slots out of list
+    size_t* localRank;      ///< capacity elements, rank inside own sublist
+
+    size_t  sublistsCount;
+    size_t* splitters;      ///< first element of every sublist
+    size_t* sublistSize;
+    size_t* sublistNext;    ///< sublist going after this one in list, NoSublist for the last
+    size_t* offset;         ///< rank of sublist first element
+
+    long long* partial;     ///< folded sublist values, only if reduce is given
+};
+
+typedef void (*ParallelTaskType)(const size_t threadId, const size_t threadsCount,
+                                 void* context);
+
+struct RankingTaskContextType
+{
+    ListType*        list;
+    ListRankingType* ranking;
+
+    ListReduceFuncType reduce;
+    long long          identity;
+
+    std::atomic<size_t> nextSublist;
+};
+
+struct ForEachTaskContextType
+{
+    ListType*           list;
+    ListForEachFuncType func;
+    void*               context;
+};
+
+struct ToArrayTaskContextType
+{
+    ListType*        list;
+    ListRankingType* ranking;
+    int*             array;
+};
+
+struct RebuildTaskContextType
+{
+    ListType*        list;
+    ListRankingType* ranking;
+    ListElemType*    newData;
+};
+
+static inline size_t GetThreadsCount(const size_t threadsCount, const size_t listSize);
+static        void   RunInParallel  (ParallelTaskType task, void* context,
+                                     const size_t threadsCount);
+
+static inline size_t ChunkBegin(const size_t threadId, const size_t threadsCount,
+                                const size_t length);
+
+static ListErrors RankingCtor(ListRankingType* ranking, const size_t capacity,
+                                                        const size_t sublistsCount);
+static void       RankingDtor(ListRankingType* ranking);
+
+static ListErrors ListRank(ListType* list, ListRankingType* ranking,
+                           const size_t threadsCount,
+                           ListReduceFuncType reduce, const long long identity);
+
+static void ClearSublistsTask(const size_t threadId, const size_t threadsCount, void* context);
+static void WalkSublistsTask (const size_t threadId, const size_t threadsCount, void* context);
+static void ForEachTask      (const size_t threadId, const size_t threadsCount, void* context);
+static void ToArrayTask      (const size_t threadId, const size_t threadsCount, void* context);
+static void ScatterTask      (const size_t threadId, const size_t threadsCount, void* context);
+static void FreeBlocksTask   (const size_t threadId, const size_t threadsCount, void* context);
+
+ListErrors ListParallelForEach(ListType* list, ListForEachFuncType func, void* context,
+                               size_t threadsCount)
+{
+    assert(list);
+    assert(func);
+
+    ListErrors error = ListVerifyByLevel(list);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    ForEachTaskContextType taskContext = { list, func, context };
+
+    RunInParallel(ForEachTask, &taskContext, GetThreadsCount(threadsCount, list->size));
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListParallelReduce(ListType* list, ListReduceFuncType reduce,
+                              const long long identity, long long* result,
+                              size_t threadsCount)
+{
+    assert(list);
+    assert(reduce);
+    assert(result);
+
+    ListRankingType ranking = {};
+    ListErrors error = ListRank(list, &ranking, GetThreadsCount(threadsCount, list->size),
+                                reduce, identity);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    long long accumulator = identity;
+
+    for (size_t i = 0; i != NoSublist && ranking.sublistsCount != 0; i = ranking.sublistNext[i])
+        accumulator = reduce(accumulator, ranking.partial[i]);
+
+    *result = accumulator;
+
+    RankingDtor(&ranking);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListParallelToArray(ListType* list, int* array, size_t threadsCount)
+{
+    assert(list);
+    assert(array);
+
+    threadsCount = GetThreadsCount(threadsCount, list->size);
+
+    ListRankingType ranking = {};
+    ListErrors error = ListRank(list, &ranking, threadsCount, nullptr, 0);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    ToArrayTaskContextType taskContext = { list, &ranking, array };
+
+    RunInParallel(ToArrayTask, &taskContext, threadsCount);
+
+    RankingDtor(&ranking);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListParallelRebuild(ListType* list, size_t threadsCount)
+{
+    assert(list);
+
+    threadsCount = GetThreadsCount(threadsCount, list->size);
+
+    ListRankingType ranking = {};
+    ListErrors error = ListRank(list, &ranking, threadsCount, nullptr, 0);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    ListElemType* newData = (ListElemType*) list->allocator.allocFunc(list->allocator.context,
+                                                list->capacity * sizeof(*newData),
+                                                alignof(ListElemType));
+
+    if (newData == nullptr)
+    {
+        RankingDtor(&ranking);
+        return ListErrors::MEMORY_ERR;
+    }
+
+    RebuildTaskContextType taskContext = { list, &ranking, newData };
+
+    RunInParallel(ScatterTask,    &taskContext, threadsCount);
+    RunInParallel(FreeBlocksTask, &taskContext, threadsCount);
+
+    RankingDtor(&ranking);
+
+    const size_t size = list->size;
+
+    newData[0].value   = POISON;
+    newData[0].prevPos = size;
+    newData[0].nextPos = size == 0 ? 0 : 1;
+
+    list->allocator.freeFunc(list->allocator.context, list->data,
+                             list->capacity * sizeof(*list->data));
+
+    list->data          = newData;
+    list->end           = 0;
+    list->freeBlockHead = size + 1 < list->capacity ? size + 1 : 0;
+    list->isLinear      = true;
+
+    ListBitmapClear      (list->occupancy, 0);
+    ListBitmapAssignRange(list->occupancy, 1,        size + 1,       true);
+    ListBitmapAssignRange(list->occupancy, size + 1, list->capacity, false);
+
+    LIST_STATS_ADD(list, rebuilds, 1);
+
+    return ListIndexesRebuild(list);
+}
+
+static inline size_t GetThreadsCount(const size_t threadsCount, const size_t listSize)
+{
+    if (listSize < ParallelMinSize)
+        return 1;
+
+    if (threadsCount != 0)
+        return threadsCount;
+
+    const size_t hardwareThreads = std::thread::hardware_concurrency();
+
+    return hardwareThreads == 0 ? 1 : hardwareThreads;
+}
+
+static void RunInParallel(ParallelTaskType task, void* context, const size_t threadsCount)
+{
+    assert(task);
+    assert(threadsCount != 0);
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount - 1);
+
+    for (size_t i = 1; i < threadsCount; ++i)
+        threads.emplace_back(task, i, threadsCount, context);
+
+    task(0, threadsCount, context);
+
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+static inline size_t ChunkBegin(const size_t threadId, const size_t threadsCount,
+                                const size_t length)
+{
+    return (size_t)((unsigned __int128)length * threadId / threadsCount);
+}
+
+//-------Ranking---------
+
+static ListErrors RankingCtor(ListRankingType* ranking, const size_t capacity,
+                                                        const size_t sublistsCount)
+{
+    assert(ranking);
+
+    ranking->sublistOf   = (size_t*) malloc(capacity * sizeof(*ranking->sublistOf));
+    ranking->localRank   = (size_t*) malloc(capacity * sizeof(*ranking->localRank));
+
+    ranking->sublistsCount = 0;
+    ranking->splitters   = (size_t*)    calloc(sublistsCount, sizeof(*ranking->splitters));
+    ranking->sublistSize = (size_t*)    calloc(sublistsCount, sizeof(*ranking->sublistSize));
+    ranking->sublistNext = (size_t*)    calloc(sublistsCount, sizeof(*ranking->sublistNext));
+    ranking->offset      = (size_t*)    calloc(sublistsCount, sizeof(*ranking->offset));
+    ranking->partial     = (long long*) calloc(sublistsCount, sizeof(*ranking->partial));
+
+    if (ranking->sublistOf   == nullptr || ranking->localRank   == nullptr ||
+        ranking->splitters   == nullptr || ranking->sublistSize == nullptr ||
+        ranking->sublistNext == nullptr || ranking->offset      == nullptr ||
+        ranking->partial     == nullptr)
+    {
+        RankingDtor(ranking);
+        return ListErrors::MEMORY_ERR;
+    }
+
+    return ListErrors::NO_ERR;
+}
+
+static void RankingDtor(ListRankingType* ranking)
+{
+    assert(ranking);
+
+    free(ranking->sublistOf);
+    free(ranking->localRank);
+    free(ranking->splitters);
+    free(ranking->sublistSize);
+    free(ranking->sublistNext);
+    free(ranking->offset);
+    free(ranking->partial);
+
+    *ranking = {};
+}
+
+static ListErrors ListRank(ListType* list, ListRankingType* ranking,
+                           const size_t threadsCount,
+                           ListReduceFuncType reduce, const long long identity)
+{
+    assert(list);
+    assert(ranking);
+    assert(threadsCount != 0);
+
+    ListErrors error = ListVerifyByLevel(list);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    const size_t maxSublistsCount = threadsCount == 1 ? 1 : threadsCount * SublistsPerThread;
+
+    error = RankingCtor(ranking, list->capacity, maxSublistsCount);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    RankingTaskContextType taskContext = { list, ranking, reduce, identity, {0} };
+
+    RunInParallel(ClearSublistsTask, &taskContext, threadsCount);
+
+    const size_t head = ListGetHead(list);
+
+    if (head == list->end)
+        return ListErrors::NO_ERR;
+
+    //-----choosing splitters spread over data, the first sublist starts at head-----
+
+    ranking->splitters[0]  = head;
+    ranking->sublistOf[head] = 0;
+    ranking->sublistsCount = 1;
+
+    for (size_t i = 1; i < maxSublistsCount; ++i)
+    {
+        const size_t chunkEnd = ChunkBegin(i + 1, maxSublistsCount, list->capacity);
+
+        for (size_t pos = ChunkBegin(i, maxSublistsCount, list->capacity); pos < chunkEnd; ++pos)
+        {
+            if (pos == list->end || ListIsElemFree(list, pos) ||
+                ranking->sublistOf[pos] != NoSublist)
+                continue;
+
+            ranking->splitters[ranking->sublistsCount] = pos;
+            ranking->sublistOf[pos] = ranking->sublistsCount;
+            ranking->sublistsCount++;
+
+            break;
+        }
+    }
+
+    //-----walking sublists, then offsets are found in list order-----
+
+    RunInParallel(WalkSublistsTask, &taskContext, threadsCount);
+
+    size_t rank = 0;
+    for (size_t i = 0; i != NoSublist; i = ranking->sublistNext[i])
+    {
+        ranking->offset[i] = rank;
+        rank += ranking->sublistSize[i];
+    }
+
+    return ListErrors::NO_ERR;
+}
+
+static void ClearSublistsTask(const size_t threadId, const size_t threadsCount, void* context)
+{
+    assert(context);
+
+    RankingTaskContextType* taskContext = (RankingTaskContextType*)context;
+
+    const size_t capacity = taskContext->list->capacity;
+    const size_t end      = ChunkBegin(threadId + 1, threadsCount, capacity);
+
+    for (size_t pos = ChunkBegin(threadId, threadsCount, capacity); pos < end; ++pos)
+        taskContext->ranking->sublistOf[pos] = NoSublist;
+}
+
+static void WalkSublistsTask(const size_t threadId, const size_t threadsCount, void* context)
+{
+    assert(context);
+    (void)threadId;
+    (void)threadsCount;
+
+    RankingTaskContextType* taskContext = (RankingTaskContextType*)context;
+
+    const ListType*  list    = taskContext->list;
+    ListRankingType* ranking = taskContext->ranking;
+
+    while (true)
+    {
+        const size_t sublist = taskContext->nextSublist.fetch_add(1, std::memory_order_relaxed);
+
+        if (sublist >= ranking->sublistsCount)
+            return;
+
+        size_t    pos         = ranking->splitters[sublist];
+        size_t    rank        = 0;
+        long long accumulator = taskContext->identity;
+
+        while (true)
+        {
+            ranking->localRank[pos] = rank++;
+
+            if (taskContext->reduce)
+                accumulator = taskContext->reduce(accumulator, list->data[pos].value);
+
+            const size_t nextPos = list->data[pos].nextPos;
+
+            if (nextPos == list->end)
+            {
+                ranking->sublistNext[sublist] = NoSublist;
+                break;
+            }
+
+            //only splitters are marked before walking, other elements belong to this walker
+            if (ranking->sublistOf[nextPos] != NoSublist)
+            {
+                ranking->sublistNext[sublist] = ranking->sublistOf[nextPos];
+                break;
+            }
+
+            ranking->sublistOf[nextPos] = sublist;
+            pos = nextPos;
+        }
+
+        ranking->sublistSize[sublist] = rank;
+        ranking->partial[sublist]     = accumulator;
+    }
+}
+
+static void ForEachTask(const size_t threadId, const size_t threadsCount, void* context)
+{
+    assert(context);
+
+    ForEachTaskContextType* taskContext = (ForEachTaskContextType*)context;
+
+    const ListType* list = taskContext->list;
+    const size_t    end  = ChunkBegin(threadId + 1, threadsCount, list->capacity);
+
+    //free regions are skipped a word of occupancy at a time
+    for (size_t pos = ListBitmapFindNext(list->occupancy,
+                                         ChunkBegin(threadId, threadsCount, list->capacity), end);
+         pos < end; pos = ListBitmapFindNext(list->occupancy, pos + 1, end))
+    {
+        taskContext->func(list->data[pos].value, pos, taskContext->context);
+    }
+}
+
+static void ToArrayTask(const size_t threadId, const size_t threadsCount, void* context)
+{
+    assert(context);
+
+    ToArrayTaskContextType* taskContext = (ToArrayTaskContextType*)context;
+
+    const ListType*        list    = taskContext->list;
+    const ListRankingType* ranking = taskContext->ranking;
+
+    const size_t end = ChunkBegin(threadId + 1, threadsCount, list->capacity);
+
+    for (size_t pos = ChunkBegin(threadId, threadsCount, list->capacity); pos < end; ++pos)
+    {
+        const size_t sublist = ranking->sublistOf[pos];
+
+        if (sublist == NoSublist)
+            continue;
+
+        taskContext->array[ranking->offset[sublist] + ranking->localRank[pos]] =
+            list->data[pos].value;
+    }
+}
+
+static void ScatterTask(const size_t threadId, const size_t threadsCount, void* context)
+{
+    assert(context);
+
+    RebuildTaskContextType* taskContext = (RebuildTaskContextType*)context;
+
+    const ListType*        list    = taskContext->list;
+    const ListRankingType* ranking = taskContext->ranking;
+    ListElemType*          newData = taskContext->newData;
+
+    const size_t end = ChunkBegin(threadId + 1, threadsCount, list->capacity);
+
+    for (size_t pos = ChunkBegin(threadId, threadsCount, list->capacity); pos < end; ++pos)
+    {
+        const size_t sublist = ranking->sublistOf[pos];
+
+        if (sublist == NoSublist)
+            continue;
+
+        //element of rank r goes to slot r + 1, slot 0 stays for end
+        const size_t newPos = ranking->offset[sublist] + ranking->localRank[pos] + 1;
+
+        newData[newPos].value   = list->data[pos].value;
+        newData[newPos].prevPos = newPos - 1;
+        newData[newPos].nextPos = newPos == list->size ? 0 : newPos + 1;
+    }
+}
+
+static void FreeBlocksTask(const size_t threadId, const size_t threadsCount, void* context)
+{
+    assert(context);
+
+    RebuildTaskContextType* taskContext = (RebuildTaskContextType*)context;
+
+    const ListType* list    = taskContext->list;
+    ListElemType*   newData = taskContext->newData;
+
+    const size_t freeBegin  = list->size + 1;
+
+    if (freeBegin >= list->capacity)
+        return;
+
+    const size_t freeLength = list->capacity - freeBegin;
+
+    const size_t begin = freeBegin + ChunkBegin(threadId,     threadsCount, freeLength);
+    const size_t end   = freeBegin + ChunkBegin(threadId + 1, threadsCount, freeLength);
+
+    for (size_t pos = begin; pos < end; ++pos)
+    {
+        newData[pos].value   = POISON;
+        newData[pos].prevPos = pos == freeBegin ? 0 : pos - 1;
+        newData[pos].nextPos = pos + 1 == list->capacity ? 0 : pos + 1;
+    }
+}
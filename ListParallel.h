@@ -0,0 +1,36 @@
+#ifndef LIST_PARALLEL_H
+#define LIST_PARALLEL_H
+
+#include <stddef.h>
+
+#include "List.h"
+
+/// \file
+/// \brief Multithreaded traversal algorithms.
+/// \details Order independent algorithms split data physically between threads.
+///          Order dependent ones use list ranking: list is cut into sublists at
+///          splitter elements, threads walk sublists, then sublist offsets are found
+///          by one short serial pass. threadsCount = 0 means hardware concurrency.
+
+typedef void      (*ListForEachFuncType)(const int value, const size_t pos, void* context);
+
+/// @brief Associative operation used both to fold values and to combine partial results
+typedef long long (*ListReduceFuncType) (const long long accumulator, const long long value);
+
+/// @brief Calls func for every element, order of calls is not specified
+ListErrors ListParallelForEach(ListType* list, ListForEachFuncType func, void* context,
+                               size_t threadsCount = 0);
+
+/// @brief Folds values in list order: reduce(...reduce(reduce(identity, v1), v2)..., vn)
+ListErrors ListParallelReduce (ListType* list, ListReduceFuncType reduce,
+                               const long long identity, long long* result,
+                               size_t threadsCount = 0);
+
+/// @brief Writes values in list order to array of at least list->size elements
+ListErrors ListParallelToArray(ListType* list, int* array, size_t threadsCount = 0);
+
+/// @brief Moves elements to slots 1..size in list order, free blocks follow them
+/// @details Positions of elements change, capacity is kept
+ListErrors ListParallelRebuild(ListType* list, size_t threadsCount = 0);
+
+#endif
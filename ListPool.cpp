@@ -0,0 +1,448 @@
+#include <assert.h>
+
+#include "Log.h"
+#include "Errors.h"
+#include "ListPool.h"
+
+static const size_t PoolMinCapacity = 16;
+static const int    POISON          = 0xDEAD;
+
+static inline void PoolDataInit(ListElemType* data, const size_t leftBorder,
+                                                    const size_t rightBorder);
+static inline void PoolElemInit(ListElemType* elem, const int value,
+                                                    const size_t prevPos,
+                                                    const size_t nextPos);
+
+static inline ListErrors PoolCapacityIncrease(ListPoolType* pool);
+static inline ListErrors PoolGetPosForNewVal (ListPoolType* pool, size_t* pos);
+static inline void       PoolAddFreeBlock    (ListPoolType* pool, const size_t newPos);
+
+static inline void PoolErrorPayloadInit(const ListPoolType* pool, ErrorPayloadType* payload);
+static        void PoolErrorFormat     (const int code, const ErrorPayloadType* payload);
+
+//dumps are too slow for error bursts, snapshot is logged later by error thread
+#define LIST_POOL_CHECK(pool)                                       \
+do                                                                  \
+{                                                                   \
+    ListErrors poolErr = ListPoolVerify(pool);                      \
+                                                                    \
+    if (poolErr != ListErrors::NO_ERR)                              \
+    {                                                               \
+        ErrorPayloadType errorPayload = {};                         \
+        PoolErrorPayloadInit(pool, &errorPayload);                  \
+        ERROR_RECORD(poolErr, &errorPayload, PoolErrorFormat);      \
+        return poolErr;                                             \
+    }                                                               \
+} while (0)
+
+ListErrors ListPoolCtor(ListPoolType* pool, const size_t poolStandardCapacity,
+                        const ListAllocatorType* allocator)
+{
+    assert(pool);
+
+    size_t capacity = poolStandardCapacity;
+    if (capacity < PoolMinCapacity)
+        capacity = PoolMinCapacity;
+
+    pool->allocator = allocator ? *allocator : ListStandardAllocator();
+
+    pool->data = (ListElemType*) pool->allocator.allocFunc(pool->allocator.context,
+                                                           capacity * sizeof(*pool->data),
+                                                           alignof(ListElemType));
+
+    if (pool->data == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    pool->capacity = capacity;
+    pool->size     = 0;
+
+    //slot 0 is never given away, it terminates the free chain
+    PoolElemInit(&pool->data[0], POISON, 0, 0);
+    PoolDataInit(pool->data, 1, pool->capacity);
+
+    pool->freeBlockHead = 1;
+
+    LIST_POOL_CHECK(pool);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListPoolDtor(ListPoolType* pool)
+{
+    assert(pool);
+
+    if (pool->data != nullptr)
+        pool->allocator.freeFunc(pool->allocator.context, pool->data,
+                                 pool->capacity * sizeof(*pool->data));
+
+    pool->freeBlockHead = 0;
+    pool->capacity = pool->size = 0;
+
+    pool->data = nullptr;
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListPoolVerify(ListPoolType* pool)
+{
+    assert(pool);
+
+    if (pool->data == nullptr)
+        return ListErrors::DATA_IS_NULLPTR;
+
+    if (pool->capacity <= pool->size)
+        return ListErrors::OUT_OF_RANGE;
+
+    if (pool->data[0].value != POISON)
+        return ListErrors::INVALID_NULLPTR;
+
+    if (pool->freeBlockHead >= pool->capacity)
+        return ListErrors::OUT_OF_RANGE;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListPoolListCtor(ListPoolType* pool, size_t* listEnd)
+{
+    assert(pool);
+    assert(listEnd);
+
+    LIST_POOL_CHECK(pool);
+
+    size_t sentinelPos = 0;
+    ListErrors error = PoolGetPosForNewVal(pool, &sentinelPos);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    //sentinel value is number of nodes of list
+    PoolElemInit(&pool->data[sentinelPos], 0, sentinelPos, sentinelPos);
+
+    *listEnd = sentinelPos;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListPoolListDtor(ListPoolType* pool, const size_t listEnd)
+{
+    assert(pool);
+    assert(listEnd != 0 && listEnd < pool->capacity);
+
+    LIST_POOL_CHECK(pool);
+
+    //nodes and sentinel
+    const size_t slotsCount = ListPoolListGetSize(pool, listEnd) + 1;
+
+    const size_t listTail = pool->data[listEnd].prevPos;
+
+    pool->data[listTail].nextPos = pool->freeBlockHead;
+    pool->freeBlockHead          = listEnd;
+
+    pool->data[listEnd].value = POISON;
+
+    pool->size -= slotsCount;
+
+    return ListErrors::NO_ERR;
+}
+
+size_t ListPoolListGetSize(const ListPoolType* pool, const size_t listEnd)
+{
+    assert(pool);
+    assert(listEnd != 0 && listEnd < pool->capacity);
+
+    return (size_t)(unsigned)pool->data[listEnd].value;
+}
+
+ListErrors ListPoolInsert(ListPoolType* pool, const size_t listEnd, const size_t anchorPos,
+                          const int value, size_t* insertedValPos)
+{
+    assert(pool);
+    assert(insertedValPos);
+    assert(listEnd   != 0 && listEnd   < pool->capacity);
+    assert(anchorPos != 0 && anchorPos < pool->capacity);
+
+    LIST_POOL_CHECK(pool);
+
+    size_t newValPos = 0;
+    ListErrors error = PoolGetPosForNewVal(pool, &newValPos);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    const size_t prevAnchor = pool->data[anchorPos].prevPos;
+
+    PoolElemInit(&pool->data[newValPos], value, prevAnchor, anchorPos);
+
+    pool->data[prevAnchor].nextPos = newValPos;
+    pool->data[anchorPos].prevPos  = newValPos;
+
+    pool->data[listEnd].value++;
+
+    *insertedValPos = newValPos;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListPoolErase(ListPoolType* pool, const size_t listEnd, const size_t anchorPos)
+{
+    assert(pool);
+    assert(listEnd   != 0 && listEnd   < pool->capacity);
+    assert(anchorPos != 0 && anchorPos < pool->capacity);
+
+    LIST_POOL_CHECK(pool);
+
+    if (anchorPos == listEnd)
+        return ListErrors::TRYING_TO_CHANGE_NULL_ELEMENT;
+
+    pool->data[pool->data[anchorPos].prevPos].nextPos = pool->data[anchorPos].nextPos;
+    pool->data[pool->data[anchorPos].nextPos].prevPos = pool->data[anchorPos].prevPos;
+
+    PoolAddFreeBlock(pool, anchorPos);
+
+    pool->data[listEnd].value--;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListPoolMove(ListPoolType* pool, const size_t listEnd,    const size_t pos,
+                                            const size_t newListEnd, const size_t newAnchorPos)
+{
+    assert(pool);
+    assert(listEnd      != 0 && listEnd      < pool->capacity);
+    assert(newListEnd   != 0 && newListEnd   < pool->capacity);
+    assert(pos          != 0 && pos          < pool->capacity);
+    assert(newAnchorPos != 0 && newAnchorPos < pool->capacity);
+
+    LIST_POOL_CHECK(pool);
+
+    if (pos == listEnd)
+        return ListErrors::TRYING_TO_CHANGE_NULL_ELEMENT;
+
+    if (pos == newAnchorPos || pool->data[newAnchorPos].prevPos == pos)
+        return ListErrors::NO_ERR;
+
+    //unlink
+    pool->data[pool->data[pos].prevPos].nextPos = pool->data[pos].nextPos;
+    pool->data[pool->data[pos].nextPos].prevPos = pool->data[pos].prevPos;
+
+    //link before new anchor
+    const size_t prevAnchor = pool->data[newAnchorPos].prevPos;
+
+    pool->data[pos].prevPos = prevAnchor;
+    pool->data[pos].nextPos = newAnchorPos;
+
+    pool->data[prevAnchor].nextPos   = pos;
+    pool->data[newAnchorPos].prevPos = pos;
+
+    pool->data[listEnd].value--;
+    pool->data[newListEnd].value++;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListPoolGetNextElem(ListPoolType* pool, size_t pos, size_t* nextElemPos)
+{
+    assert(pool);
+    assert(nextElemPos);
+
+    LIST_POOL_CHECK(pool);
+
+    *nextElemPos = pool->data[pos].nextPos;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListPoolGetPrevElem(ListPoolType* pool, size_t pos, size_t* prevElemPos)
+{
+    assert(pool);
+    assert(prevElemPos);
+
+    LIST_POOL_CHECK(pool);
+
+    *prevElemPos = pool->data[pos].prevPos;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListPoolGetElemValue(ListPoolType* pool, size_t pos, int* elemValue)
+{
+    assert(pool);
+    assert(elemValue);
+
+    if (pos == 0)
+        return ListErrors::TRYING_TO_GET_NULL_ELEMENT;
+
+    LIST_POOL_CHECK(pool);
+
+    *elemValue = pool->data[pos].value;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListPoolSetElemValue(ListPoolType* pool, size_t pos, int newElemValue)
+{
+    assert(pool);
+
+    if (pos == 0)
+        return ListErrors::TRYING_TO_CHANGE_NULL_ELEMENT;
+
+    LIST_POOL_CHECK(pool);
+
+    pool->data[pos].value = newElemValue;
+
+    return ListErrors::NO_ERR;
+}
+
+size_t ListPoolGetHead(const ListPoolType* pool, const size_t listEnd)
+{
+    assert(pool);
+
+    return pool->data[listEnd].nextPos;
+}
+
+size_t ListPoolGetTail(const ListPoolType* pool, const size_t listEnd)
+{
+    assert(pool);
+
+    return pool->data[listEnd].prevPos;
+}
+
+bool ListPoolListIsEmpty(const ListPoolType* pool, const size_t listEnd)
+{
+    assert(pool);
+
+    return pool->data[listEnd].nextPos == listEnd;
+}
+
+static inline void PoolErrorPayloadInit(const ListPoolType* pool, ErrorPayloadType* payload)
+{
+    assert(pool);
+    assert(payload);
+
+    //only pool fields are copied, data may be broken
+    payload->words[0] = (uint64_t)pool->data;
+    payload->words[1] = pool->freeBlockHead;
+    payload->words[2] = pool->size;
+    payload->words[3] = pool->capacity;
+}
+
+static void PoolErrorFormat(const int code, const ErrorPayloadType* payload)
+{
+    Log("%s", ListErrorsGetMessage((ListErrors)code));
+
+    if (payload == nullptr)
+        return;
+
+    Log("Pool data: %p, free blocks head: %llu, size: %llu, capacity: %llu\n",
+        (void*)payload->words[0], (unsigned long long)payload->words[1],
+        (unsigned long long)payload->words[2], (unsigned long long)payload->words[3]);
+}
+
+void ListPoolTextDump(const ListPoolType* pool, const char* fileName,
+                                                const char* funcName,
+                                                const int   line)
+{
+    assert(pool);
+    assert(fileName);
+    assert(funcName);
+
+    LogBegin(fileName, funcName, line);
+
+    static const size_t numberOfElementsToPrint = 16;
+
+    Log("Pool free blocks head: %zu\n", pool->freeBlockHead);
+
+    Log("Pool capacity: %zu\n", pool->capacity);
+    Log("Pool size    : %zu\n", pool->size);
+
+    Log("Data[%p]:\n", pool->data);
+
+    for (size_t i = 0; pool->data && i < numberOfElementsToPrint && i < pool->capacity; ++i)
+    {
+        Log("\tElement id: %zu, value: %d, previous position: %zu, next position: %zu\n",
+            i, pool->data[i].value, pool->data[i].prevPos, pool->data[i].nextPos);
+    }
+
+    Log("\t...\n");
+
+    LOG_END();
+}
+
+static inline void PoolDataInit(ListElemType* data, const size_t leftBorder,
+                                                    const size_t rightBorder)
+{
+    assert(data);
+    assert(leftBorder != 0);
+    assert(leftBorder < rightBorder);
+
+    for (size_t i = leftBorder; i < rightBorder - 1; ++i)
+        PoolElemInit(&data[i], POISON, 0, i + 1);
+
+    PoolElemInit(&data[rightBorder - 1], POISON, 0, 0);
+}
+
+static inline void PoolElemInit(ListElemType* elem, const int value,
+                                                    const size_t prevPos,
+                                                    const size_t nextPos)
+{
+    assert(elem);
+
+    elem->value   = value;
+    elem->prevPos = prevPos;
+    elem->nextPos = nextPos;
+}
+
+static inline ListErrors PoolCapacityIncrease(ListPoolType* pool)
+{
+    assert(pool);
+    assert(pool->freeBlockHead == 0);
+
+    const size_t newCapacity = pool->capacity * 2;
+
+    void* tmpPtr = pool->allocator.reallocFunc(pool->allocator.context, pool->data,
+                                               pool->capacity * sizeof(*pool->data),
+                                               newCapacity    * sizeof(*pool->data),
+                                               alignof(ListElemType));
+
+    if (tmpPtr == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    pool->data = (ListElemType*)tmpPtr;
+
+    PoolDataInit(pool->data, pool->capacity, newCapacity);
+
+    pool->freeBlockHead = pool->capacity;
+    pool->capacity      = newCapacity;
+
+    return ListErrors::NO_ERR;
+}
+
+static inline ListErrors PoolGetPosForNewVal(ListPoolType* pool, size_t* pos)
+{
+    assert(pool);
+    assert(pos);
+
+    ListErrors error = ListErrors::NO_ERR;
+    if (pool->freeBlockHead == 0)
+        error = PoolCapacityIncrease(pool);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    *pos = pool->freeBlockHead;
+    pool->freeBlockHead = pool->data[pool->freeBlockHead].nextPos;
+
+    pool->size++;
+
+    return ListErrors::NO_ERR;
+}
+
+static inline void PoolAddFreeBlock(ListPoolType* pool, const size_t newPos)
+{
+    assert(pool);
+    assert(newPos != 0 && newPos < pool->capacity);
+
+    PoolElemInit(&pool->data[newPos], POISON, 0, pool->freeBlockHead);
+    pool->freeBlockHead = newPos;
+
+    pool->size--;
+}
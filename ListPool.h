@@ -0,0 +1,71 @@
+#ifndef LIST_POOL_H
+#define LIST_POOL_H
+
+#include <stddef.h>
+
+#include "List.h"
+
+/// \file
+/// \brief Many lightweight lists sharing one node arena.
+/// \details Every list in a pool is just a sentinel slot index. Nodes of all lists
+///          and free slots live in one data array, so creating a list takes one slot
+///          from the shared free chain and nodes can be moved between lists by relinking.
+///          Value of sentinel keeps number of nodes of its list, so operations changing
+///          it take list handle besides node positions.
+
+struct ListPoolType
+{
+    ListElemType* data;
+
+    size_t freeBlockHead;
+
+    size_t size;        ///< number of used slots (nodes and sentinels)
+    size_t capacity;
+
+    ListAllocatorType allocator;
+};
+
+ListErrors ListPoolCtor  (ListPoolType* pool, const size_t capacity = 0,
+                          const ListAllocatorType* allocator = nullptr);
+ListErrors ListPoolDtor  (ListPoolType* pool);
+ListErrors ListPoolVerify(ListPoolType* pool);
+
+/// @brief Creates new empty list in pool
+/// @param [out]listEnd sentinel position of the new list, used as list handle
+ListErrors ListPoolListCtor(ListPoolType* pool, size_t* listEnd);
+
+/// @brief Destroys list and returns all its nodes to the pool in O(1)
+/// @details Nodes are spliced to free chain at once, their number is kept by sentinel.
+ListErrors ListPoolListDtor(ListPoolType* pool, const size_t listEnd);
+
+/// @brief Number of nodes of list
+size_t     ListPoolListGetSize(const ListPoolType* pool, const size_t listEnd);
+
+/// @param [in]listEnd list of anchorPos
+ListErrors ListPoolInsert(ListPoolType* pool, const size_t listEnd, const size_t anchorPos,
+                          const int value, size_t* insertedValPos);
+/// @param [in]listEnd list of anchorPos
+ListErrors ListPoolErase (ListPoolType* pool, const size_t listEnd, const size_t anchorPos);
+
+/// @brief Relinks node pos of list listEnd before newAnchorPos of list newListEnd,
+///        lists may be the same
+ListErrors ListPoolMove  (ListPoolType* pool, const size_t listEnd,    const size_t pos,
+                                              const size_t newListEnd, const size_t newAnchorPos);
+
+ListErrors ListPoolGetNextElem (ListPoolType* pool, size_t pos, size_t* nextElemPos);
+ListErrors ListPoolGetPrevElem (ListPoolType* pool, size_t pos, size_t* prevElemPos);
+ListErrors ListPoolGetElemValue(ListPoolType* pool, size_t pos, int* elemValue);
+/// @details pos must be node, value of sentinel is size of its list
+ListErrors ListPoolSetElemValue(ListPoolType* pool, size_t pos, int  newElemValue);
+
+size_t ListPoolGetHead(const ListPoolType* pool, const size_t listEnd);
+size_t ListPoolGetTail(const ListPoolType* pool, const size_t listEnd);
+
+bool   ListPoolListIsEmpty(const ListPoolType* pool, const size_t listEnd);
+
+#define LIST_POOL_TEXT_DUMP(pool) ListPoolTextDump((pool), __FILE__, __func__, __LINE__)
+void ListPoolTextDump(const ListPoolType* pool, const char* fileName,
+                                                const char* funcName,
+                                                const int   line);
+
+#endif
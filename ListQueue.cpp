@@ -0,0 +1,179 @@
+#include <assert.h>
+
+#include <new>
+
+#include "ListQueue.h"
+
+static const uint64_t IndexMask = 0xFFFFFFFFull;
+static const int      TagShift  = 32;
+
+static inline bool PopFreeBlock (ListQueueType* queue, size_t* pos);
+static inline void PushFreeBlock(ListQueueType* queue, const size_t pos);
+
+static inline uint64_t MakeTagged(const uint64_t oldTagged, const size_t pos);
+
+ListErrors ListQueueCtor(ListQueueType* queue, const size_t capacity,
+                         const ListQueueMode mode,
+                         const ListAllocatorType* allocator)
+{
+    assert(queue);
+    assert(capacity != 0);
+
+    //slot 0 is null, one more slot is always taken by consumer dummy
+    const size_t slotsCount = capacity + 2;
+
+    if (slotsCount > IndexMask)
+        return ListErrors::OUT_OF_RANGE;
+
+    queue->allocator = allocator ? *allocator : ListStandardAllocator();
+
+    queue->data = (ListQueueNodeType*) queue->allocator.allocFunc(queue->allocator.context,
+                                                                  slotsCount * sizeof(*queue->data),
+                                                                  alignof(ListQueueNodeType));
+
+    if (queue->data == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    queue->slotsCount = slotsCount;
+    queue->mode       = mode;
+
+    //allocator gives raw memory, atomics have to be constructed before use
+    for (size_t i = 0; i < slotsCount; ++i)
+    {
+        ListQueueNodeType* node = new (&queue->data[i]) ListQueueNodeType;
+
+        node->value = 0;
+        node->nextPos.store(i + 1 < slotsCount ? i + 1 : 0, std::memory_order_relaxed);
+    }
+
+    queue->data[0].nextPos.store(0, std::memory_order_relaxed);
+    queue->data[1].nextPos.store(0, std::memory_order_relaxed);
+
+    queue->head = 1;
+    queue->tail.store(1, std::memory_order_relaxed);
+
+    queue->freeBlockHead.store(2, std::memory_order_release);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListQueueDtor(ListQueueType* queue)
+{
+    assert(queue);
+
+    if (queue->data != nullptr)
+    {
+        for (size_t i = 0; i < queue->slotsCount; ++i)
+            queue->data[i].~ListQueueNodeType();
+
+        queue->allocator.freeFunc(queue->allocator.context, queue->data,
+                                  queue->slotsCount * sizeof(*queue->data));
+    }
+
+    queue->data       = nullptr;
+    queue->slotsCount = 0;
+    queue->head       = 0;
+
+    queue->tail.store(0, std::memory_order_relaxed);
+    queue->freeBlockHead.store(0, std::memory_order_relaxed);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListQueuePush(ListQueueType* queue, const int value)
+{
+    assert(queue);
+    assert(queue->data);
+
+    size_t newValPos = 0;
+    if (!PopFreeBlock(queue, &newValPos))
+        return ListErrors::QUEUE_IS_FULL;
+
+    queue->data[newValPos].value = value;
+    queue->data[newValPos].nextPos.store(0, std::memory_order_relaxed);
+
+    size_t prevTail = 0;
+
+    if (queue->mode == ListQueueMode::SPSC)
+    {
+        prevTail = queue->tail.load(std::memory_order_relaxed);
+        queue->tail.store(newValPos, std::memory_order_relaxed);
+    }
+    else
+        prevTail = queue->tail.exchange(newValPos, std::memory_order_acq_rel);
+
+    //publishes value: consumer reads it after acquiring this link
+    queue->data[prevTail].nextPos.store(newValPos, std::memory_order_release);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListQueuePop(ListQueueType* queue, int* value)
+{
+    assert(queue);
+    assert(queue->data);
+    assert(value);
+
+    const size_t dummyPos = queue->head;
+    const size_t nextPos  = queue->data[dummyPos].nextPos.load(std::memory_order_acquire);
+
+    if (nextPos == 0)
+        return ListErrors::QUEUE_IS_EMPTY;
+
+    //node with value becomes new dummy
+    *value      = queue->data[nextPos].value;
+    queue->head = nextPos;
+
+    PushFreeBlock(queue, dummyPos);
+
+    return ListErrors::NO_ERR;
+}
+
+static inline uint64_t MakeTagged(const uint64_t oldTagged, const size_t pos)
+{
+    const uint64_t tag = (oldTagged >> TagShift) + 1;
+
+    return (tag << TagShift) | pos;
+}
+
+static inline bool PopFreeBlock(ListQueueType* queue, size_t* pos)
+{
+    assert(queue);
+    assert(pos);
+
+    uint64_t oldHead = queue->freeBlockHead.load(std::memory_order_acquire);
+
+    while (true)
+    {
+        const size_t headPos = oldHead & IndexMask;
+
+        if (headPos == 0)
+            return false;
+
+        //may be stale if the block was taken meanwhile, then tag mismatch fails the exchange
+        const size_t nextPos = queue->data[headPos].nextPos.load(std::memory_order_relaxed);
+
+        if (queue->freeBlockHead.compare_exchange_weak(oldHead, MakeTagged(oldHead, nextPos),
+                                                       std::memory_order_acquire,
+                                                       std::memory_order_acquire))
+        {
+            *pos = headPos;
+            return true;
+        }
+    }
+}
+
+static inline void PushFreeBlock(ListQueueType* queue, const size_t pos)
+{
+    assert(queue);
+    assert(pos != 0 && pos < queue->slotsCount);
+
+    uint64_t oldHead = queue->freeBlockHead.load(std::memory_order_relaxed);
+
+    do
+    {
+        queue->data[pos].nextPos.store(oldHead & IndexMask, std::memory_order_relaxed);
+    } while (!queue->freeBlockHead.compare_exchange_weak(oldHead, MakeTagged(oldHead, pos),
+                                                         std::memory_order_release,
+                                                         std::memory_order_relaxed));
+}
@@ -0,0 +1,61 @@
+#ifndef LIST_QUEUE_H
+#define LIST_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "List.h"
+
+/// \file
+/// \brief Lock-free FIFO queue built on index-linked storage.
+/// \details Nodes live in one fixed data array and are linked by indices, slot 0 is null.
+///          Consumer keeps a dummy node, producers append by swapping tail index
+///          (Vyukov intrusive queue). Free slots are kept in a lock-free stack whose head
+///          is tagged with a change counter against ABA. Capacity is fixed at construction.
+
+enum class ListQueueMode
+{
+    SPSC, ///< one producer, one consumer: tail is updated with plain store
+    MPSC, ///< many producers, one consumer: tail is updated with exchange
+};
+
+struct ListQueueNodeType
+{
+    int value;
+
+    std::atomic<size_t> nextPos;
+};
+
+struct ListQueueType
+{
+    ListQueueNodeType* data;
+    size_t slotsCount;    ///< capacity + 2: null slot and consumer dummy
+
+    ListQueueMode mode;
+
+    ListAllocatorType allocator;
+
+    alignas(64) std::atomic<size_t>   tail;          ///< written by producers
+    alignas(64) size_t                head;          ///< dummy node, used by consumer only
+    alignas(64) std::atomic<uint64_t> freeBlockHead; ///< tag << 32 | index
+};
+
+/// @brief Creates queue able to keep capacity values at once
+ListErrors ListQueueCtor(ListQueueType* queue, const size_t capacity,
+                         const ListQueueMode mode = ListQueueMode::MPSC,
+                         const ListAllocatorType* allocator = nullptr);
+
+/// @brief Destroys queue, no other thread may use it
+ListErrors ListQueueDtor(ListQueueType* queue);
+
+/// @brief Appends value, callable from producer threads
+/// @return QUEUE_IS_FULL if no free slot is left
+ListErrors ListQueuePush(ListQueueType* queue, const int value);
+
+/// @brief Takes value from the front, callable from consumer thread only
+/// @return QUEUE_IS_EMPTY if nothing is published yet
+ListErrors ListQueuePop (ListQueueType* queue, int* value);
+
+#endif
@@ -0,0 +1,404 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include "Log.h"
+#include "List.h"
+#include "ListOrderIndex.h"
+#include "ListValueIndex.h"
+#include "ListStats.h"
+#include "ListTrace.h"
+
+static const size_t OpsCount = (size_t)ListTraceOp::SNAPSHOT_END + 1;
+
+static const char* const OpNames[OpsCount] =
+    { "", "insert", "erase", "detach", "release", "move", "get", "set", "clear", "snapshot" };
+
+struct ReplayConfigType
+{
+    const char* traceName;
+
+    size_t          capacity;
+    ListAllocPolicy allocPolicy;
+    ListVerifyLevel verifyLevel;
+
+    bool isOrderIndex;
+    bool isValueIndex;
+
+    size_t repeatsCount;
+};
+
+struct ReplayResultType
+{
+    ListHistogramType* histograms;  ///< latency of every operation, ns
+
+    uint64_t opsCount;
+    uint64_t totalNs;
+
+    uint64_t snapshotsCount;
+    uint64_t skippedCount;          ///< records with positions unknown to replay
+};
+
+static bool       ParseArgs  (const int argc, const char* argv[], ReplayConfigType* config);
+static void       PrintUsage (const char* programName);
+static ListErrors ReplayOnce (const ReplayConfigType* config, ReplayResultType* result);
+static ListErrors ReplayClear(ListType* list, std::vector<size_t>* posMap);
+static ListErrors ReplayOp   (ListType* list, const ListTraceRecordType* record,
+                              std::vector<size_t>* posMap, bool* isSkipped);
+static void       PrintResult(const ReplayConfigType* config, const ReplayResultType* result);
+
+static inline uint64_t NowNs();
+
+int main(const int argc, const char* argv[])
+{
+    LogOpen(argv[0]);
+
+    ReplayConfigType config =
+    {
+        nullptr, 0, ListAllocPolicy::FREE_HEAD, ListVerifyLevel::FULL, false, false, 1
+    };
+
+    if (!ParseArgs(argc, argv, &config))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ReplayResultType result = {};
+    result.histograms = (ListHistogramType*)calloc(OpsCount, sizeof(*result.histograms));
+
+    if (result.histograms == nullptr)
+        return EXIT_FAILURE;
+
+    for (size_t i = 0; i < config.repeatsCount; ++i)
+    {
+        ListErrors error = ReplayOnce(&config, &result);
+
+        if (error != ListErrors::NO_ERR)
+        {
+            fprintf(stderr, "Replay of %s failed, error %d\n", config.traceName, (int)error);
+            free(result.histograms);
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    PrintResult(&config, &result);
+
+    free(result.histograms);
+
+    return EXIT_SUCCESS;
+}
+
+static bool ParseArgs(const int argc, const char* argv[], ReplayConfigType* config)
+{
+    assert(argv);
+    assert(config);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg     = argv[i];
+        const char* nextArg = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (strcmp(arg, "--order-index") == 0)
+            config->isOrderIndex = true;
+        else if (strcmp(arg, "--value-index") == 0)
+            config->isValueIndex = true;
+        else if (nextArg != nullptr && strcmp(arg, "--capacity") == 0)
+            config->capacity     = strtoull(argv[++i], nullptr, 10);
+        else if (nextArg != nullptr && strcmp(arg, "--repeat") == 0)
+            config->repeatsCount = strtoull(argv[++i], nullptr, 10);
+        else if (nextArg != nullptr && strcmp(arg, "--policy") == 0)
+        {
+            if      (strcmp(nextArg, "free-head")   == 0)
+                config->allocPolicy = ListAllocPolicy::FREE_HEAD;
+            else if (strcmp(nextArg, "near-anchor") == 0)
+                config->allocPolicy = ListAllocPolicy::NEAR_ANCHOR;
+            else
+                return false;
+
+            ++i;
+        }
+        else if (nextArg != nullptr && strcmp(arg, "--verify") == 0)
+        {
+            if      (strcmp(nextArg, "none")   == 0)
+                config->verifyLevel = ListVerifyLevel::NONE;
+            else if (strcmp(nextArg, "header") == 0)
+                config->verifyLevel = ListVerifyLevel::HEADER;
+            else if (strcmp(nextArg, "full")   == 0)
+                config->verifyLevel = ListVerifyLevel::FULL;
+            else
+                return false;
+
+            ++i;
+        }
+        else if (arg[0] != '-' && config->traceName == nullptr)
+            config->traceName = arg;
+        else
+            return false;
+    }
+
+    return config->traceName != nullptr && config->repeatsCount != 0;
+}
+
+static void PrintUsage(const char* programName)
+{
+    assert(programName);
+
+    fprintf(stderr, "Usage: %s trace [--capacity N] [--policy free-head|near-anchor]\n"
+                    "       [--verify none|header|full] [--order-index] [--value-index]\n"
+                    "       [--repeat N]\n", programName);
+}
+
+static ListErrors ReplayOnce(const ReplayConfigType* config, ReplayResultType* result)
+{
+    assert(config);
+    assert(result);
+
+    //reader buffer with stats of list is over stack limit
+    ListTraceReaderType* reader = (ListTraceReaderType*)calloc(1, sizeof(*reader));
+
+    if (reader == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    ListErrors error = ListTraceReaderOpen(reader, config->traceName);
+
+    if (error != ListErrors::NO_ERR)
+    {
+        free(reader);
+        return error;
+    }
+
+    ListType list = {};
+
+    if ((error = ListCtor(&list, config->capacity)) != ListErrors::NO_ERR)
+    {
+        ListTraceReaderClose(reader);
+        free(reader);
+        return error;
+    }
+
+    ListSetAllocPolicy(&list, config->allocPolicy);
+    ListSetVerifyLevel(&list, config->verifyLevel);
+
+    if ((config->isOrderIndex && (error = ListOrderIndexEnable(&list)) != ListErrors::NO_ERR) ||
+        (config->isValueIndex && (error = ListValueIndexEnable(&list)) != ListErrors::NO_ERR))
+    {
+        ListDtor(&list);
+        ListTraceReaderClose(reader);
+        free(reader);
+        return error;
+    }
+
+    //trace position -> position in replayed list, 0 if unknown
+    std::vector<size_t> posMap;
+    ListTraceRecordType record = {};
+
+    //snapshot is not part of measured work, its records are applied untimed
+    bool isSnapshot = false;
+
+    while (error == ListErrors::NO_ERR && ListTraceRead(reader, &record))
+    {
+        if (record.op == ListTraceOp::CLEAR)
+        {
+            error = ReplayClear(&list, &posMap);
+            result->snapshotsCount++;
+
+            isSnapshot = true;
+            continue;
+        }
+
+        if (record.op == ListTraceOp::SNAPSHOT_END)
+        {
+            isSnapshot = false;
+            continue;
+        }
+
+        bool isSkipped = false;
+
+        if (isSnapshot)
+        {
+            error = ReplayOp(&list, &record, &posMap, &isSkipped);
+            continue;
+        }
+
+        const uint64_t beginNs = NowNs();
+        error = ReplayOp(&list, &record, &posMap, &isSkipped);
+        const uint64_t elapsedNs = NowNs() - beginNs;
+
+        if (isSkipped)
+        {
+            result->skippedCount++;
+            continue;
+        }
+
+        ListHistogramAdd(&result->histograms[(size_t)record.op], elapsedNs);
+
+        result->opsCount++;
+        result->totalNs += elapsedNs;
+    }
+
+    ListDtor(&list);
+    ListTraceReaderClose(reader);
+    free(reader);
+
+    return error;
+}
+
+static ListErrors ReplayClear(ListType* list, std::vector<size_t>* posMap)
+{
+    assert(list);
+    assert(posMap);
+
+    while (list->size != 0)
+    {
+        ListErrors error = ListErase(list, ListGetHead(list));
+
+        if (error != ListErrors::NO_ERR)
+            return error;
+    }
+
+    posMap->assign(posMap->size(), 0);
+
+    return ListErrors::NO_ERR;
+}
+
+static ListErrors ReplayOp(ListType* list, const ListTraceRecordType* record,
+                           std::vector<size_t>* posMap, bool* isSkipped)
+{
+    assert(list);
+    assert(record);
+    assert(posMap);
+    assert(isSkipped);
+
+    const size_t pos       = record->pos       < posMap->size() ? (*posMap)[record->pos]
+                                                                 : 0;
+    const size_t anchorPos = record->anchorPos < posMap->size() ? (*posMap)[record->anchorPos]
+                                                                 : 0;
+
+    //end of trace is end of list, any other position has to be mapped already
+    const bool isPosKnown    = pos != 0;
+    const bool isAnchorKnown = anchorPos != 0 || record->anchorPos == 0;
+
+    int value = 0;
+
+    switch (record->op)
+    {
+        case ListTraceOp::INSERT:
+        {
+            if (!isAnchorKnown)
+                break;
+
+            size_t newPos = 0;
+            ListErrors error = ListInsert(list, anchorPos == 0 ? list->end : anchorPos,
+                                          record->value, &newPos);
+
+            if (record->pos >= posMap->size())
+                posMap->resize(record->pos + 1, 0);
+
+            (*posMap)[record->pos] = newPos;
+
+            return error;
+        }
+
+        case ListTraceOp::ERASE:
+            if (!isPosKnown)
+                break;
+
+            (*posMap)[record->pos] = 0;
+            return ListErase(list, pos);
+
+        case ListTraceOp::DETACH:
+            if (!isPosKnown)
+                break;
+
+            return ListDetach(list, pos);
+
+        case ListTraceOp::RELEASE:
+            if (!isPosKnown)
+                break;
+
+            (*posMap)[record->pos] = 0;
+            return ListReleaseSlot(list, pos);
+
+        case ListTraceOp::MOVE:
+            if (!isPosKnown || !isAnchorKnown)
+                break;
+
+            return ListMoveBefore(list, pos, anchorPos == 0 ? list->end : anchorPos);
+
+        case ListTraceOp::GET:
+            if (!isPosKnown)
+                break;
+
+            return ListGetElemValue(list, pos, &value);
+
+        case ListTraceOp::SET:
+            if (!isPosKnown)
+                break;
+
+            return ListSetElemValue(list, pos, record->value);
+
+        case ListTraceOp::CLEAR:
+        case ListTraceOp::SNAPSHOT_END:
+        default:
+            break;
+    }
+
+    *isSkipped = true;
+
+    return ListErrors::NO_ERR;
+}
+
+static void PrintResult(const ReplayConfigType* config, const ReplayResultType* result)
+{
+    assert(config);
+    assert(result);
+
+    printf("Trace %s replayed %zu time(s)\n", config->traceName, config->repeatsCount);
+    printf("Config: capacity %zu, policy %s, verify %s, order index %s, value index %s\n",
+           config->capacity,
+           config->allocPolicy == ListAllocPolicy::FREE_HEAD ? "free-head" : "near-anchor",
+           config->verifyLevel == ListVerifyLevel::NONE   ? "none"   :
+           config->verifyLevel == ListVerifyLevel::HEADER ? "header" : "full",
+           config->isOrderIndex ? "on" : "off", config->isValueIndex ? "on" : "off");
+
+    const double totalMs = (double)result->totalNs / 1e6;
+
+    printf("Operations: %llu in %.3f ms, %.3f Mops/s, snapshots: %llu, skipped: %llu\n",
+           (unsigned long long)result->opsCount, totalMs,
+           result->totalNs == 0 ? 0 : (double)result->opsCount / totalMs / 1e3,
+           (unsigned long long)result->snapshotsCount,
+           (unsigned long long)result->skippedCount);
+
+    printf("%-8s %12s %8s %8s %8s %8s %10s\n",
+           "op", "count", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns");
+
+    for (size_t op = 1; op < OpsCount; ++op)
+    {
+        const ListHistogramType* histogram = &result->histograms[op];
+
+        if (histogram->total == 0)
+            continue;
+
+        printf("%-8s %12llu %8llu %8llu %8llu %8llu %10llu\n", OpNames[op],
+               (unsigned long long)histogram->total,
+               (unsigned long long)ListHistogramPercentile(histogram, 0.5),
+               (unsigned long long)ListHistogramPercentile(histogram, 0.9),
+               (unsigned long long)ListHistogramPercentile(histogram, 0.99),
+               (unsigned long long)ListHistogramPercentile(histogram, 0.999),
+               (unsigned long long)histogram->maxValue);
+    }
+}
+
+static inline uint64_t NowNs()
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
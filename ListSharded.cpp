@@ -0,0 +1,285 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include <thread>
+#include <vector>
+
+#include "ListSharded.h"
+#include "ListBitmap.h"
+#include "ListFreeChain.h"
+
+static inline size_t GetThreadsCount(const size_t threadsCount);
+
+static ListShardedPosType SkipEmptyShards(const ListShardedType* sharded, size_t shard);
+
+static void ConsolidateTask(const ListShardedType* sharded, ListType* target,
+                            const size_t* offsets, const size_t threadId,
+                                                   const size_t threadsCount);
+
+ListErrors ListShardedCtor(ListShardedType* sharded, size_t shardsCount,
+                           const size_t shardCapacity, const ListAllocatorType* allocator)
+{
+    assert(sharded);
+
+    shardsCount = GetThreadsCount(shardsCount);
+
+    sharded->allocator = allocator ? *allocator : ListStandardAllocator();
+
+    sharded->shards = (ListShardType*) sharded->allocator.allocFunc(sharded->allocator.context,
+                                                            shardsCount * sizeof(ListShardType),
+                                                            alignof(ListShardType));
+
+    if (sharded->shards == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    for (size_t i = 0; i < shardsCount; ++i)
+    {
+        ListErrors error = ListCtor(&sharded->shards[i].list, shardCapacity, &sharded->allocator);
+
+        if (error != ListErrors::NO_ERR)
+        {
+            while (i-- > 0)
+                ListDtor(&sharded->shards[i].list);
+
+            sharded->allocator.freeFunc(sharded->allocator.context, sharded->shards,
+                                        shardsCount * sizeof(ListShardType));
+            sharded->shards = nullptr;
+
+            return error;
+        }
+    }
+
+    sharded->shardsCount = shardsCount;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListShardedDtor(ListShardedType* sharded)
+{
+    assert(sharded);
+
+    if (sharded->shards == nullptr)
+        return ListErrors::NO_ERR;
+
+    for (size_t i = 0; i < sharded->shardsCount; ++i)
+        ListDtor(&sharded->shards[i].list);
+
+    sharded->allocator.freeFunc(sharded->allocator.context, sharded->shards,
+                                sharded->shardsCount * sizeof(ListShardType));
+
+    sharded->shards      = nullptr;
+    sharded->shardsCount = 0;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListShardedVerify(ListShardedType* sharded)
+{
+    assert(sharded);
+
+    if (sharded->shards == nullptr)
+        return ListErrors::DATA_IS_NULLPTR;
+
+    for (size_t i = 0; i < sharded->shardsCount; ++i)
+    {
+        ListErrors error = ListVerify(&sharded->shards[i].list);
+
+        if (error != ListErrors::NO_ERR)
+            return error;
+    }
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListShardedAppend(ListShardedType* sharded, const size_t shard, const int value,
+                             ListShardedPosType* insertedPos)
+{
+    assert(sharded);
+    assert(shard < sharded->shardsCount);
+
+    ListType* list = &sharded->shards[shard].list;
+
+    size_t pos = 0;
+    ListErrors error = ListInsert(list, list->end, value, &pos);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    if (insertedPos)
+        *insertedPos = { shard, pos };
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListShardedErase(ListShardedType* sharded, const ListShardedPosType pos)
+{
+    assert(sharded);
+    assert(pos.shard < sharded->shardsCount);
+
+    return ListErase(&sharded->shards[pos.shard].list, pos.pos);
+}
+
+void ListShardedSetVerifyLevel(ListShardedType* sharded, const ListVerifyLevel level)
+{
+    assert(sharded);
+
+    for (size_t i = 0; i < sharded->shardsCount; ++i)
+        ListSetVerifyLevel(&sharded->shards[i].list, level);
+}
+
+size_t ListShardedGetSize(const ListShardedType* sharded)
+{
+    assert(sharded);
+
+    size_t size = 0;
+    for (size_t i = 0; i < sharded->shardsCount; ++i)
+        size += sharded->shards[i].list.size;
+
+    return size;
+}
+
+ListShardedPosType ListShardedBegin(const ListShardedType* sharded)
+{
+    assert(sharded);
+
+    return SkipEmptyShards(sharded, 0);
+}
+
+ListShardedPosType ListShardedNext(const ListShardedType* sharded, const ListShardedPosType pos)
+{
+    assert(sharded);
+    assert(pos.shard < sharded->shardsCount);
+
+    const ListType* list = &sharded->shards[pos.shard].list;
+    const size_t nextPos = list->data[pos.pos].nextPos;
+
+    if (nextPos != list->end)
+        return { pos.shard, nextPos };
+
+    return SkipEmptyShards(sharded, pos.shard + 1);
+}
+
+bool ListShardedIsEnd(const ListShardedType* sharded, const ListShardedPosType pos)
+{
+    assert(sharded);
+
+    return pos.shard == sharded->shardsCount;
+}
+
+int ListShardedGetValue(const ListShardedType* sharded, const ListShardedPosType pos)
+{
+    assert(sharded);
+    assert(pos.shard < sharded->shardsCount);
+
+    return sharded->shards[pos.shard].list.data[pos.pos].value;
+}
+
+ListErrors ListShardedConsolidate(ListShardedType* sharded, ListType* target,
+                                  size_t threadsCount)
+{
+    assert(sharded);
+    assert(target);
+
+    threadsCount = GetThreadsCount(threadsCount);
+    if (threadsCount > sharded->shardsCount)
+        threadsCount = sharded->shardsCount;
+
+    //offsets[i] is slot of first element of shard i in target
+    std::vector<size_t> offsets(sharded->shardsCount + 1);
+
+    offsets[0] = 1;
+    for (size_t i = 0; i < sharded->shardsCount; ++i)
+        offsets[i + 1] = offsets[i] + sharded->shards[i].list.size;
+
+    const size_t size = offsets[sharded->shardsCount] - 1;
+
+    ListErrors error = ListCtor(target, size + 1, &sharded->allocator);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    //shards share verify level set by ListShardedSetVerifyLevel
+    ListSetVerifyLevel(target, sharded->shards[0].list.verifyLevel);
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount - 1);
+
+    for (size_t i = 1; i < threadsCount; ++i)
+        threads.emplace_back(ConsolidateTask, sharded, target, offsets.data(), i, threadsCount);
+
+    ConsolidateTask(sharded, target, offsets.data(), 0, threadsCount);
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    //tasks link slots 1..size as if every shard continues to the next one
+    target->data[target->end].prevPos = size;
+    target->data[target->end].nextPos = size == 0 ? 0 : 1;
+
+    if (size != 0)
+        target->data[size].nextPos = target->end;
+
+    target->size     = size;
+    target->isLinear = true;
+
+    ListBitmapAssignRange(target->occupancy, 1, size + 1, true);
+
+    target->freeBlockHead = ListFreeChainInit(target->data, size + 1, target->capacity);
+
+    error = ListVerifyByLevel(target);
+
+    if (error != ListErrors::NO_ERR)
+        ListDtor(target);
+
+    return error;
+}
+
+static inline size_t GetThreadsCount(const size_t threadsCount)
+{
+    if (threadsCount != 0)
+        return threadsCount;
+
+    const size_t hardwareThreads = std::thread::hardware_concurrency();
+
+    return hardwareThreads == 0 ? 1 : hardwareThreads;
+}
+
+static ListShardedPosType SkipEmptyShards(const ListShardedType* sharded, size_t shard)
+{
+    assert(sharded);
+
+    while (shard < sharded->shardsCount && sharded->shards[shard].list.size == 0)
+        shard++;
+
+    if (shard == sharded->shardsCount)
+        return { sharded->shardsCount, 0 };
+
+    const ListType* list = &sharded->shards[shard].list;
+
+    return { shard, list->data[list->end].nextPos };
+}
+
+static void ConsolidateTask(const ListShardedType* sharded, ListType* target,
+                            const size_t* offsets, const size_t threadId,
+                                                   const size_t threadsCount)
+{
+    assert(sharded);
+    assert(target);
+    assert(offsets);
+
+    //shards are dealt round robin, every shard is copied by one thread
+    for (size_t shard = threadId; shard < sharded->shardsCount; shard += threadsCount)
+    {
+        const ListType* list = &sharded->shards[shard].list;
+
+        size_t slot = offsets[shard];
+
+        for (size_t pos = list->data[list->end].nextPos; pos != list->end;
+                    pos = list->data[pos].nextPos, ++slot)
+        {
+            target->data[slot].value   = list->data[pos].value;
+            target->data[slot].prevPos = slot - 1;
+            target->data[slot].nextPos = slot + 1;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef LIST_SHARDED_H
+#define LIST_SHARDED_H
+
+#include <stddef.h>
+
+#include "List.h"
+
+/// \file
+/// \brief List split into shards, every thread appends to own shard without locks.
+/// \details Shard is ordinary ListType with own data, end sentinel and free blocks,
+///          shards sit on separate cache lines. Logical order is shard number, then
+///          order inside shard, so position is shard and slot in it. Shard may be
+///          changed by one thread at a time, different shards are changed concurrently.
+///          Merged iterator walks shards one by one, consolidation copies shards to
+///          one linear list in parallel.
+
+struct alignas(64) ListShardType
+{
+    ListType list;
+};
+
+struct ListShardedType
+{
+    ListShardType* shards;
+    size_t         shardsCount;
+
+    ListAllocatorType allocator;
+};
+
+struct ListShardedPosType
+{
+    size_t shard;
+    size_t pos;
+};
+
+/// @brief Creates shardsCount shards, 0 means hardware concurrency
+ListErrors ListShardedCtor(ListShardedType* sharded, size_t shardsCount,
+                           const size_t shardCapacity = 0,
+                           const ListAllocatorType* allocator = nullptr);
+ListErrors ListShardedDtor(ListShardedType* sharded);
+ListErrors ListShardedVerify(ListShardedType* sharded);
+
+/// @brief Appends value to the end of shard, called by thread owning shard
+ListErrors ListShardedAppend(ListShardedType* sharded, const size_t shard, const int value,
+                             ListShardedPosType* insertedPos = nullptr);
+
+/// @brief Erases element, called by thread owning its shard
+ListErrors ListShardedErase (ListShardedType* sharded, const ListShardedPosType pos);
+
+void       ListShardedSetVerifyLevel(ListShardedType* sharded, const ListVerifyLevel level);
+
+/// @brief Number of elements, shards must not be changed meanwhile
+size_t     ListShardedGetSize(const ListShardedType* sharded);
+
+//-------Merged iteration, shards must not be changed meanwhile---------
+
+ListShardedPosType ListShardedBegin(const ListShardedType* sharded);
+ListShardedPosType ListShardedNext (const ListShardedType* sharded, const ListShardedPosType pos);
+bool               ListShardedIsEnd(const ListShardedType* sharded, const ListShardedPosType pos);
+int                ListShardedGetValue(const ListShardedType* sharded,
+                                       const ListShardedPosType pos);
+
+/// @brief Builds linear list of all elements in logical order, shards are kept
+/// @details Target gets verify level of shards and is checked by it.
+/// @param [out]target not constructed list, elements get slots 1..size, destroyed on failure
+ListErrors ListShardedConsolidate(ListShardedType* sharded, ListType* target,
+                                  size_t threadsCount = 0);
+
+#endif
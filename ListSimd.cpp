@@ -0,0 +1,676 @@
+#include <assert.h>
+#include <limits.h>
+
+#include "ListSimd.h"
+#include "ListBitmap.h"
+
+#ifdef __x86_64__
+#define LIST_SIMD_X86
+#include <immintrin.h>
+#endif
+
+/// distance between values of neighbouring slots in ints
+static const int ValueStride = (int)(sizeof(ListElemType) / sizeof(int));
+
+static_assert(sizeof(ListElemType) % sizeof(int) == 0, "values have to be gatherable");
+
+typedef size_t    (*FindFirstKernelType)(const ListElemType* data, size_t begin, size_t end,
+                                         const int value);
+typedef size_t    (*CountIfKernelType)  (const ListElemType* data, size_t begin, size_t end,
+                                         const ListSimdCmpOp op, const int operand,
+                                         const uint64_t* occupancy);
+typedef void      (*MinMaxKernelType)   (const ListElemType* data, size_t begin, size_t end,
+                                         const uint64_t* occupancy, int* minValue, int* maxValue);
+typedef long long (*SumKernelType)      (const ListElemType* data, size_t begin, size_t end,
+                                         const uint64_t* occupancy);
+
+struct SimdKernelsType
+{
+    ListSimdLevel level;
+
+    FindFirstKernelType findFirst;
+    CountIfKernelType   countIf;
+    MinMaxKernelType    minMax;
+    SumKernelType       sum;
+};
+
+static const SimdKernelsType* GetKernels();
+static SimdKernelsType        ChooseKernels();
+
+static inline void GetScanRange(const ListType* list, size_t* begin, size_t* end,
+                                                      const uint64_t** occupancy);
+static inline size_t SkipFreeWords(const uint64_t* occupancy, size_t pos, const size_t end);
+
+static inline bool CmpScalar(const int value, const ListSimdCmpOp op, const int operand);
+
+//-------Scalar kernels---------
+
+static size_t    FindFirstScalar(const ListElemType* data, size_t begin, size_t end,
+                                 const int value);
+static size_t    CountIfScalar  (const ListElemType* data, size_t begin, size_t end,
+                                 const ListSimdCmpOp op, const int operand,
+                                 const uint64_t* occupancy);
+static void      MinMaxScalar   (const ListElemType* data, size_t begin, size_t end,
+                                 const uint64_t* occupancy, int* minValue, int* maxValue);
+static long long SumScalar      (const ListElemType* data, size_t begin, size_t end,
+                                 const uint64_t* occupancy);
+
+#ifdef LIST_SIMD_X86
+
+//-------SSE4.1 kernels---------
+
+static size_t    FindFirstSse4(const ListElemType* data, size_t begin, size_t end,
+                               const int value);
+static size_t    CountIfSse4  (const ListElemType* data, size_t begin, size_t end,
+                               const ListSimdCmpOp op, const int operand,
+                               const uint64_t* occupancy);
+static void      MinMaxSse4   (const ListElemType* data, size_t begin, size_t end,
+                               const uint64_t* occupancy, int* minValue, int* maxValue);
+static long long SumSse4      (const ListElemType* data, size_t begin, size_t end,
+                               const uint64_t* occupancy);
+
+//-------AVX2 kernels---------
+
+static size_t    FindFirstAvx2(const ListElemType* data, size_t begin, size_t end,
+                               const int value);
+static size_t    CountIfAvx2  (const ListElemType* data, size_t begin, size_t end,
+                               const ListSimdCmpOp op, const int operand,
+                               const uint64_t* occupancy);
+static void      MinMaxAvx2   (const ListElemType* data, size_t begin, size_t end,
+                               const uint64_t* occupancy, int* minValue, int* maxValue);
+static long long SumAvx2      (const ListElemType* data, size_t begin, size_t end,
+                               const uint64_t* occupancy);
+
+#endif
+
+ListSimdLevel ListSimdGetLevel()
+{
+    return GetKernels()->level;
+}
+
+ListErrors ListSimdFindFirst(ListType* list, const int value, size_t* pos)
+{
+    assert(list);
+    assert(pos);
+
+    if (!list->isLinear)
+    {
+        for (size_t i = ListGetHead(list); i != list->end; i = list->data[i].nextPos)
+        {
+            if (list->data[i].value == value)
+            {
+                *pos = i;
+                return ListErrors::NO_ERR;
+            }
+        }
+
+        return ListErrors::VALUE_NOT_FOUND;
+    }
+
+    const size_t foundPos = GetKernels()->findFirst(list->data, 1, list->size + 1, value);
+
+    if (foundPos == 0)
+        return ListErrors::VALUE_NOT_FOUND;
+
+    *pos = foundPos;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListSimdCountIf(ListType* list, const ListSimdCmpOp op, const int operand,
+                           size_t* count)
+{
+    assert(list);
+    assert(count);
+
+    size_t begin = 0, end = 0;
+    const uint64_t* occupancy = nullptr;
+    GetScanRange(list, &begin, &end, &occupancy);
+
+    *count = GetKernels()->countIf(list->data, begin, end, op, operand, occupancy);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListSimdMinMax(ListType* list, int* minValue, int* maxValue)
+{
+    assert(list);
+    assert(minValue);
+    assert(maxValue);
+
+    if (list->size == 0)
+        return ListErrors::OUT_OF_RANGE;
+
+    size_t begin = 0, end = 0;
+    const uint64_t* occupancy = nullptr;
+    GetScanRange(list, &begin, &end, &occupancy);
+
+    GetKernels()->minMax(list->data, begin, end, occupancy, minValue, maxValue);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListSimdSum(ListType* list, long long* sum)
+{
+    assert(list);
+    assert(sum);
+
+    size_t begin = 0, end = 0;
+    const uint64_t* occupancy = nullptr;
+    GetScanRange(list, &begin, &end, &occupancy);
+
+    *sum = GetKernels()->sum(list->data, begin, end, occupancy);
+
+    return ListErrors::NO_ERR;
+}
+
+static inline void GetScanRange(const ListType* list, size_t* begin, size_t* end,
+                                                      const uint64_t** occupancy)
+{
+    assert(list);
+    assert(begin);
+    assert(end);
+    assert(occupancy);
+    assert(list->end == 0);
+
+    if (list->isLinear)
+    {
+        *begin     = 1;
+        *end       = list->size + 1;
+        *occupancy = nullptr;
+    }
+    else
+    {
+        //scan starts at 0 so vectors are aligned to occupancy bytes, end slot bit is clear
+        *begin     = 0;
+        *end       = list->capacity;
+        *occupancy = list->occupancy;
+    }
+}
+
+static inline size_t SkipFreeWords(const uint64_t* occupancy, size_t pos, const size_t end)
+{
+    while (occupancy != nullptr && pos % ListBitmapWordBits == 0 &&
+           pos + ListBitmapWordBits <= end && occupancy[pos / ListBitmapWordBits] == 0)
+        pos += ListBitmapWordBits;
+
+    return pos;
+}
+
+static const SimdKernelsType* GetKernels()
+{
+    static const SimdKernelsType kernels = ChooseKernels();
+
+    return &kernels;
+}
+
+static SimdKernelsType ChooseKernels()
+{
+#ifdef LIST_SIMD_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        return { ListSimdLevel::AVX2, FindFirstAvx2, CountIfAvx2, MinMaxAvx2, SumAvx2 };
+
+    if (__builtin_cpu_supports("sse4.1"))
+        return { ListSimdLevel::SSE4, FindFirstSse4, CountIfSse4, MinMaxSse4, SumSse4 };
+#endif
+
+    return { ListSimdLevel::SCALAR, FindFirstScalar, CountIfScalar, MinMaxScalar, SumScalar };
+}
+
+static inline bool CmpScalar(const int value, const ListSimdCmpOp op, const int operand)
+{
+    switch (op)
+    {
+        case ListSimdCmpOp::EQ:
+            return value == operand;
+        case ListSimdCmpOp::NE:
+            return value != operand;
+        case ListSimdCmpOp::LT:
+            return value <  operand;
+        case ListSimdCmpOp::LE:
+            return value <= operand;
+        case ListSimdCmpOp::GT:
+            return value >  operand;
+        case ListSimdCmpOp::GE:
+            return value >= operand;
+
+        default:
+            assert(false);
+            return false;
+    }
+}
+
+//-------Scalar kernels---------
+
+static size_t FindFirstScalar(const ListElemType* data, size_t begin, size_t end,
+                              const int value)
+{
+    assert(data);
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (data[i].value == value)
+            return i;
+    }
+
+    return 0;
+}
+
+static size_t CountIfScalar(const ListElemType* data, size_t begin, size_t end,
+                            const ListSimdCmpOp op, const int operand,
+                            const uint64_t* occupancy)
+{
+    assert(data);
+
+    size_t count = 0;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (occupancy != nullptr && (i = ListBitmapFindNext(occupancy, i, end)) == end)
+            break;
+
+        count += CmpScalar(data[i].value, op, operand);
+    }
+
+    return count;
+}
+
+static void MinMaxScalar(const ListElemType* data, size_t begin, size_t end,
+                         const uint64_t* occupancy, int* minValue, int* maxValue)
+{
+    assert(data);
+    assert(minValue);
+    assert(maxValue);
+
+    int minFound = INT_MAX;
+    int maxFound = INT_MIN;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (occupancy != nullptr && (i = ListBitmapFindNext(occupancy, i, end)) == end)
+            break;
+
+        minFound = data[i].value < minFound ? data[i].value : minFound;
+        maxFound = data[i].value > maxFound ? data[i].value : maxFound;
+    }
+
+    *minValue = minFound;
+    *maxValue = maxFound;
+}
+
+static long long SumScalar(const ListElemType* data, size_t begin, size_t end,
+                           const uint64_t* occupancy)
+{
+    assert(data);
+
+    long long sum = 0;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (occupancy != nullptr && (i = ListBitmapFindNext(occupancy, i, end)) == end)
+            break;
+
+        sum += data[i].value;
+    }
+
+    return sum;
+}
+
+#ifdef LIST_SIMD_X86
+
+//-------SSE4.1 kernels---------
+//no gather in SSE, values of 4 slots are assembled by scalar loads
+
+#define SSE4 __attribute__((target("sse4.1")))
+
+SSE4 static inline __m128i LoadSse4(const ListElemType* data, const size_t pos)
+{
+    return _mm_setr_epi32(data[pos].value,     data[pos + 1].value,
+                          data[pos + 2].value, data[pos + 3].value);
+}
+
+/// lanes of occupied slots are all ones, pos is multiple of 4
+SSE4 static inline __m128i OccupiedSse4(const uint64_t* occupancy, const size_t pos)
+{
+    assert(pos % 4 == 0);
+
+    const int     bits  = (int)((occupancy[pos / ListBitmapWordBits] >>
+                                (pos % ListBitmapWordBits)) & 0xF);
+    const __m128i lanes = _mm_setr_epi32(1, 2, 4, 8);
+
+    return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(bits), lanes), lanes);
+}
+
+SSE4 static inline __m128i CmpSse4(const __m128i values, const __m128i operand,
+                                   const ListSimdCmpOp op)
+{
+    const __m128i ones = _mm_set1_epi32(-1);
+
+    switch (op)
+    {
+        case ListSimdCmpOp::EQ:
+            return _mm_cmpeq_epi32(values, operand);
+        case ListSimdCmpOp::NE:
+            return _mm_xor_si128(_mm_cmpeq_epi32(values, operand), ones);
+        case ListSimdCmpOp::LT:
+            return _mm_cmpgt_epi32(operand, values);
+        case ListSimdCmpOp::LE:
+            return _mm_xor_si128(_mm_cmpgt_epi32(values, operand), ones);
+        case ListSimdCmpOp::GT:
+            return _mm_cmpgt_epi32(values, operand);
+        case ListSimdCmpOp::GE:
+            return _mm_xor_si128(_mm_cmpgt_epi32(operand, values), ones);
+
+        default:
+            assert(false);
+            return _mm_setzero_si128();
+    }
+}
+
+SSE4 static size_t FindFirstSse4(const ListElemType* data, size_t begin, size_t end,
+                                 const int value)
+{
+    assert(data);
+
+    const __m128i valueVec = _mm_set1_epi32(value);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        const unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(
+                                        _mm_cmpeq_epi32(LoadSse4(data, i), valueVec)));
+
+        if (mask != 0)
+            return i + (size_t)__builtin_ctz(mask);
+    }
+
+    return FindFirstScalar(data, i, end, value);
+}
+
+SSE4 static size_t CountIfSse4(const ListElemType* data, size_t begin, size_t end,
+                               const ListSimdCmpOp op, const int operand,
+                               const uint64_t* occupancy)
+{
+    assert(data);
+
+    const __m128i operandVec = _mm_set1_epi32(operand);
+
+    size_t count = 0;
+
+    size_t i = begin;
+    for (i = SkipFreeWords(occupancy, i, end); i + 4 <= end;
+         i = SkipFreeWords(occupancy, i + 4, end))
+    {
+        const __m128i values = LoadSse4(data, i);
+
+        __m128i matched = CmpSse4(values, operandVec, op);
+        if (occupancy != nullptr)
+            matched = _mm_and_si128(OccupiedSse4(occupancy, i), matched);
+
+        count += (size_t)__builtin_popcount((unsigned)_mm_movemask_ps(
+                                                        _mm_castsi128_ps(matched)));
+    }
+
+    return count + CountIfScalar(data, i, end, op, operand, occupancy);
+}
+
+SSE4 static void MinMaxSse4(const ListElemType* data, size_t begin, size_t end,
+                            const uint64_t* occupancy, int* minValue, int* maxValue)
+{
+    assert(data);
+    assert(minValue);
+    assert(maxValue);
+
+    __m128i minVec = _mm_set1_epi32(INT_MAX);
+    __m128i maxVec = _mm_set1_epi32(INT_MIN);
+
+    size_t i = begin;
+    for (i = SkipFreeWords(occupancy, i, end); i + 4 <= end;
+         i = SkipFreeWords(occupancy, i + 4, end))
+    {
+        const __m128i values = LoadSse4(data, i);
+
+        __m128i forMin = values;
+        __m128i forMax = values;
+
+        if (occupancy != nullptr)
+        {
+            const __m128i occupied = OccupiedSse4(occupancy, i);
+
+            forMin = _mm_blendv_epi8(_mm_set1_epi32(INT_MAX), values, occupied);
+            forMax = _mm_blendv_epi8(_mm_set1_epi32(INT_MIN), values, occupied);
+        }
+
+        minVec = _mm_min_epi32(minVec, forMin);
+        maxVec = _mm_max_epi32(maxVec, forMax);
+    }
+
+    int tailMin = 0, tailMax = 0;
+    MinMaxScalar(data, i, end, occupancy, &tailMin, &tailMax);
+
+    minVec = _mm_min_epi32(minVec, _mm_shuffle_epi32(minVec, _MM_SHUFFLE(1, 0, 3, 2)));
+    minVec = _mm_min_epi32(minVec, _mm_shuffle_epi32(minVec, _MM_SHUFFLE(2, 3, 0, 1)));
+    maxVec = _mm_max_epi32(maxVec, _mm_shuffle_epi32(maxVec, _MM_SHUFFLE(1, 0, 3, 2)));
+    maxVec = _mm_max_epi32(maxVec, _mm_shuffle_epi32(maxVec, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    const int vecMin = _mm_cvtsi128_si32(minVec);
+    const int vecMax = _mm_cvtsi128_si32(maxVec);
+
+    *minValue = vecMin < tailMin ? vecMin : tailMin;
+    *maxValue = vecMax > tailMax ? vecMax : tailMax;
+}
+
+SSE4 static long long SumSse4(const ListElemType* data, size_t begin, size_t end,
+                              const uint64_t* occupancy)
+{
+    assert(data);
+
+    __m128i sumVec = _mm_setzero_si128();
+
+    size_t i = begin;
+    for (i = SkipFreeWords(occupancy, i, end); i + 4 <= end;
+         i = SkipFreeWords(occupancy, i + 4, end))
+    {
+        __m128i values = LoadSse4(data, i);
+        if (occupancy != nullptr)
+            values = _mm_and_si128(OccupiedSse4(occupancy, i), values);
+
+        sumVec = _mm_add_epi64(sumVec, _mm_cvtepi32_epi64(values));
+        sumVec = _mm_add_epi64(sumVec, _mm_cvtepi32_epi64(_mm_srli_si128(values, 8)));
+    }
+
+    const long long vecSum = _mm_cvtsi128_si64(sumVec) +
+                             _mm_extract_epi64(sumVec, 1);
+
+    return vecSum + SumScalar(data, i, end, occupancy);
+}
+
+#undef SSE4
+
+//-------AVX2 kernels---------
+//values of 8 slots are fetched by one gather with stride of list element
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static inline __m256i LoadAvx2(const ListElemType* data, const size_t pos)
+{
+    const __m256i offsets = _mm256_setr_epi32(0,               ValueStride,
+                                              2 * ValueStride, 3 * ValueStride,
+                                              4 * ValueStride, 5 * ValueStride,
+                                              6 * ValueStride, 7 * ValueStride);
+
+    return _mm256_i32gather_epi32(&data[pos].value, offsets, sizeof(int));
+}
+
+AVX2 static inline unsigned MaskAvx2(const __m256i mask)
+{
+    return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(mask));
+}
+
+/// lanes of occupied slots are all ones, pos is multiple of 8
+AVX2 static inline __m256i OccupiedAvx2(const uint64_t* occupancy, const size_t pos)
+{
+    assert(pos % 8 == 0);
+
+    const int     bits  = (int)((occupancy[pos / ListBitmapWordBits] >>
+                                (pos % ListBitmapWordBits)) & 0xFF);
+    const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+
+    return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(bits), lanes), lanes);
+}
+
+AVX2 static inline __m256i CmpAvx2(const __m256i values, const __m256i operand,
+                                   const ListSimdCmpOp op)
+{
+    const __m256i ones = _mm256_set1_epi32(-1);
+
+    switch (op)
+    {
+        case ListSimdCmpOp::EQ:
+            return _mm256_cmpeq_epi32(values, operand);
+        case ListSimdCmpOp::NE:
+            return _mm256_xor_si256(_mm256_cmpeq_epi32(values, operand), ones);
+        case ListSimdCmpOp::LT:
+            return _mm256_cmpgt_epi32(operand, values);
+        case ListSimdCmpOp::LE:
+            return _mm256_xor_si256(_mm256_cmpgt_epi32(values, operand), ones);
+        case ListSimdCmpOp::GT:
+            return _mm256_cmpgt_epi32(values, operand);
+        case ListSimdCmpOp::GE:
+            return _mm256_xor_si256(_mm256_cmpgt_epi32(operand, values), ones);
+
+        default:
+            assert(false);
+            return _mm256_setzero_si256();
+    }
+}
+
+AVX2 static size_t FindFirstAvx2(const ListElemType* data, size_t begin, size_t end,
+                                 const int value)
+{
+    assert(data);
+
+    const __m256i valueVec = _mm256_set1_epi32(value);
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8)
+    {
+        const unsigned mask = MaskAvx2(_mm256_cmpeq_epi32(LoadAvx2(data, i), valueVec));
+
+        if (mask != 0)
+            return i + (size_t)__builtin_ctz(mask);
+    }
+
+    return FindFirstScalar(data, i, end, value);
+}
+
+AVX2 static size_t CountIfAvx2(const ListElemType* data, size_t begin, size_t end,
+                               const ListSimdCmpOp op, const int operand,
+                               const uint64_t* occupancy)
+{
+    assert(data);
+
+    const __m256i operandVec = _mm256_set1_epi32(operand);
+
+    size_t count = 0;
+
+    size_t i = begin;
+    for (i = SkipFreeWords(occupancy, i, end); i + 8 <= end;
+         i = SkipFreeWords(occupancy, i + 8, end))
+    {
+        const __m256i values = LoadAvx2(data, i);
+
+        __m256i matched = CmpAvx2(values, operandVec, op);
+        if (occupancy != nullptr)
+            matched = _mm256_and_si256(OccupiedAvx2(occupancy, i), matched);
+
+        count += (size_t)__builtin_popcount(MaskAvx2(matched));
+    }
+
+    return count + CountIfScalar(data, i, end, op, operand, occupancy);
+}
+
+AVX2 static void MinMaxAvx2(const ListElemType* data, size_t begin, size_t end,
+                            const uint64_t* occupancy, int* minValue, int* maxValue)
+{
+    assert(data);
+    assert(minValue);
+    assert(maxValue);
+
+    __m256i minVec = _mm256_set1_epi32(INT_MAX);
+    __m256i maxVec = _mm256_set1_epi32(INT_MIN);
+
+    size_t i = begin;
+    for (i = SkipFreeWords(occupancy, i, end); i + 8 <= end;
+         i = SkipFreeWords(occupancy, i + 8, end))
+    {
+        const __m256i values = LoadAvx2(data, i);
+
+        __m256i forMin = values;
+        __m256i forMax = values;
+
+        if (occupancy != nullptr)
+        {
+            const __m256i occupied = OccupiedAvx2(occupancy, i);
+
+            forMin = _mm256_blendv_epi8(_mm256_set1_epi32(INT_MAX), values, occupied);
+            forMax = _mm256_blendv_epi8(_mm256_set1_epi32(INT_MIN), values, occupied);
+        }
+
+        minVec = _mm256_min_epi32(minVec, forMin);
+        maxVec = _mm256_max_epi32(maxVec, forMax);
+    }
+
+    int tailMin = 0, tailMax = 0;
+    MinMaxScalar(data, i, end, occupancy, &tailMin, &tailMax);
+
+    __m128i minHalf = _mm_min_epi32(_mm256_castsi256_si128(minVec),
+                                    _mm256_extracti128_si256(minVec, 1));
+    __m128i maxHalf = _mm_max_epi32(_mm256_castsi256_si128(maxVec),
+                                    _mm256_extracti128_si256(maxVec, 1));
+
+    minHalf = _mm_min_epi32(minHalf, _mm_shuffle_epi32(minHalf, _MM_SHUFFLE(1, 0, 3, 2)));
+    minHalf = _mm_min_epi32(minHalf, _mm_shuffle_epi32(minHalf, _MM_SHUFFLE(2, 3, 0, 1)));
+    maxHalf = _mm_max_epi32(maxHalf, _mm_shuffle_epi32(maxHalf, _MM_SHUFFLE(1, 0, 3, 2)));
+    maxHalf = _mm_max_epi32(maxHalf, _mm_shuffle_epi32(maxHalf, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    const int vecMin = _mm_cvtsi128_si32(minHalf);
+    const int vecMax = _mm_cvtsi128_si32(maxHalf);
+
+    *minValue = vecMin < tailMin ? vecMin : tailMin;
+    *maxValue = vecMax > tailMax ? vecMax : tailMax;
+}
+
+AVX2 static long long SumAvx2(const ListElemType* data, size_t begin, size_t end,
+                              const uint64_t* occupancy)
+{
+    assert(data);
+
+    __m256i sumVec = _mm256_setzero_si256();
+
+    size_t i = begin;
+    for (i = SkipFreeWords(occupancy, i, end); i + 8 <= end;
+         i = SkipFreeWords(occupancy, i + 8, end))
+    {
+        __m256i values = LoadAvx2(data, i);
+        if (occupancy != nullptr)
+            values = _mm256_and_si256(OccupiedAvx2(occupancy, i), values);
+
+        sumVec = _mm256_add_epi64(sumVec, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(values)));
+        sumVec = _mm256_add_epi64(sumVec, _mm256_cvtepi32_epi64(
+                                                    _mm256_extracti128_si256(values, 1)));
+    }
+
+    const __m128i sumHalf = _mm_add_epi64(_mm256_castsi256_si128(sumVec),
+                                          _mm256_extracti128_si256(sumVec, 1));
+
+    const long long vecSum = _mm_cvtsi128_si64(sumHalf) + _mm_extract_epi64(sumHalf, 1);
+
+    return vecSum + SumScalar(data, i, end, occupancy);
+}
+
+#undef AVX2
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef LIST_SIMD_H
+#define LIST_SIMD_H
+
+#include <stddef.h>
+
+#include "List.h"
+
+/// \file
+/// \brief Vectorized search and aggregate kernels over list values.
+/// \details Kernels are chosen once at runtime by CPUID: AVX2, SSE4.1 or scalar.
+///          Order independent kernels scan data physically and mask free slots.
+///          If list is linear (after rebuild or physical sort) slots 1..size
+///          are scanned without masks, so logical order is physical order too.
+
+enum class ListSimdCmpOp
+{
+    EQ,
+    NE,
+    LT,
+    LE,
+    GT,
+    GE,
+};
+
+enum class ListSimdLevel
+{
+    SCALAR,
+    SSE4,
+    AVX2,
+};
+
+/// @brief Level of kernels chosen for this CPU
+ListSimdLevel ListSimdGetLevel();
+
+/// @brief Finds first element in list order with value
+/// @details Vectorized if list is linear, walks the list otherwise
+ListErrors ListSimdFindFirst(ListType* list, const int value, size_t* pos);
+
+/// @brief Counts elements for which (value op operand) is true
+ListErrors ListSimdCountIf  (ListType* list, const ListSimdCmpOp op, const int operand,
+                             size_t* count);
+
+/// @brief Returns OUT_OF_RANGE for empty list
+ListErrors ListSimdMinMax   (ListType* list, int* minValue, int* maxValue);
+
+ListErrors ListSimdSum      (ListType* list, long long* sum);
+
+#endif
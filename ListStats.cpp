@@ -0,0 +1,233 @@
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+
+#include "Log.h"
+#include "List.h"
+#include "ListStats.h"
+
+static_assert(sizeof(ListStatsType) % sizeof(uint64_t) == 0, "stats are read word by word");
+
+static inline size_t   HistogramBucket    (const uint64_t value);
+static inline uint64_t HistogramBucketLow (const size_t bucket);
+
+#ifdef LIST_STATS
+
+static ListStatsType GlobalStats   = {};
+static uint64_t      LastDumpNs    = 0;
+
+static void HistogramAddGlobal(ListHistogramType* histogram, const uint64_t value);
+static void DumpGlobalIfPeriod(const uint64_t nowNs);
+
+#endif
+
+void ListGetStats(const ListType* list, ListStatsType* stats)
+{
+    assert(list);
+    assert(stats);
+
+#ifdef LIST_STATS
+    *stats = list->stats;
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+void ListGetGlobalStats(ListStatsType* stats)
+{
+    assert(stats);
+
+#ifdef LIST_STATS
+    //global stats are changed concurrently, every word is read atomically
+    const uint64_t* source = (const uint64_t*)&GlobalStats;
+    uint64_t*       target = (uint64_t*)stats;
+
+    for (size_t i = 0; i < sizeof(*stats) / sizeof(uint64_t); ++i)
+        target[i] = __atomic_load_n(&source[i], __ATOMIC_RELAXED);
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+void ListHistogramAdd(ListHistogramType* histogram, const uint64_t value)
+{
+    assert(histogram);
+
+    histogram->counts[HistogramBucket(value)]++;
+    histogram->total++;
+
+    if (value > histogram->maxValue)
+        histogram->maxValue = value;
+}
+
+uint64_t ListHistogramPercentile(const ListHistogramType* histogram, const double share)
+{
+    assert(histogram);
+    assert(0 <= share && share <= 1);
+
+    if (histogram->total == 0)
+        return 0;
+
+    const uint64_t rank = (uint64_t)(share * (double)histogram->total + 0.5);
+
+    uint64_t counted = 0;
+    for (size_t bucket = 0; bucket < ListHistogramBucketsCount; ++bucket)
+    {
+        counted += histogram->counts[bucket];
+
+        if (counted >= rank && counted != 0)
+        {
+            if (bucket + 1 == ListHistogramBucketsCount)
+                return histogram->maxValue;
+
+            const uint64_t upperBound = HistogramBucketLow(bucket + 1) - 1;
+            return upperBound < histogram->maxValue ? upperBound : histogram->maxValue;
+        }
+    }
+
+    return histogram->maxValue;
+}
+
+void ListStatsDump(const ListStatsType* stats, const char* name)
+{
+    assert(stats);
+    assert(name);
+
+    LOG_BEGIN();
+
+    Log("List stats: %s\n", name);
+
+    Log("\tInserts: %llu, erases: %llu\n",
+        (unsigned long long)stats->inserts, (unsigned long long)stats->erases);
+    Log("\tSlots from free head: %llu, near anchor: %llu\n",
+        (unsigned long long)stats->freeHeadAllocs, (unsigned long long)stats->nearAnchorAllocs);
+    Log("\tCapacity increases: %llu, decreases: %llu, rebuilds: %llu, bytes reallocated: %llu\n",
+        (unsigned long long)stats->capacityIncreases, (unsigned long long)stats->capacityDecreases,
+        (unsigned long long)stats->rebuilds,          (unsigned long long)stats->bytesReallocated);
+    Log("\tVerifies: %llu, verify time: %llu ns\n",
+        (unsigned long long)stats->verifies, (unsigned long long)stats->verifyNs);
+
+    const ListHistogramType* histograms[]     = { &stats->insertNs, &stats->eraseNs };
+    const char*              histogramNames[] = { "Insert", "Erase" };
+
+    for (size_t i = 0; i < sizeof(histograms) / sizeof(*histograms); ++i)
+    {
+        Log("\t%s ns: p50 %llu, p90 %llu, p99 %llu, p99.9 %llu, max %llu\n", histogramNames[i],
+            (unsigned long long)ListHistogramPercentile(histograms[i], 0.5),
+            (unsigned long long)ListHistogramPercentile(histograms[i], 0.9),
+            (unsigned long long)ListHistogramPercentile(histograms[i], 0.99),
+            (unsigned long long)ListHistogramPercentile(histograms[i], 0.999),
+            (unsigned long long)histograms[i]->maxValue);
+    }
+
+    LOG_END();
+}
+
+static inline size_t HistogramBucket(const uint64_t value)
+{
+    const size_t subBuckets = (size_t)1 << ListHistogramSubBucketBits;
+
+    if (value < subBuckets)
+        return value;
+
+    const size_t exponent = 63 - (size_t)__builtin_clzll(value);
+
+    if (exponent > ListHistogramMaxExponent)
+        return ListHistogramBucketsCount - 1;
+
+    //top bits after leading one choose sub bucket
+    const size_t subBucket = (value >> (exponent - ListHistogramSubBucketBits)) &
+                             (subBuckets - 1);
+
+    return ((exponent - ListHistogramSubBucketBits + 1) << ListHistogramSubBucketBits) +
+           subBucket;
+}
+
+static inline uint64_t HistogramBucketLow(const size_t bucket)
+{
+    const size_t subBuckets = (size_t)1 << ListHistogramSubBucketBits;
+
+    if (bucket < subBuckets)
+        return bucket;
+
+    const size_t exponent  = (bucket >> ListHistogramSubBucketBits) +
+                             ListHistogramSubBucketBits - 1;
+    const size_t subBucket = bucket & (subBuckets - 1);
+
+    return (subBuckets + subBucket) << (exponent - ListHistogramSubBucketBits);
+}
+
+#ifdef LIST_STATS
+
+uint64_t ListStatsNow()
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+void ListStatsAdd(ListType* list, uint64_t ListStatsType::* counter, const uint64_t value)
+{
+    assert(list);
+
+    list->stats.*counter += value;
+    __atomic_fetch_add(&(GlobalStats.*counter), value, __ATOMIC_RELAXED);
+}
+
+void ListStatsRecord(ListType* list, ListHistogramType ListStatsType::* histogram,
+                                     const uint64_t beginNs)
+{
+    assert(list);
+
+    const uint64_t nowNs = ListStatsNow();
+
+    ListHistogramAdd  (&(list->stats.*histogram), nowNs - beginNs);
+    HistogramAddGlobal(&(GlobalStats.*histogram), nowNs - beginNs);
+
+    DumpGlobalIfPeriod(nowNs);
+}
+
+static void HistogramAddGlobal(ListHistogramType* histogram, const uint64_t value)
+{
+    assert(histogram);
+
+    __atomic_fetch_add(&histogram->counts[HistogramBucket(value)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->total, 1, __ATOMIC_RELAXED);
+
+    uint64_t maxValue = __atomic_load_n(&histogram->maxValue, __ATOMIC_RELAXED);
+    while (value > maxValue &&
+           !__atomic_compare_exchange_n(&histogram->maxValue, &maxValue, value, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+static void DumpGlobalIfPeriod(const uint64_t nowNs)
+{
+    static const uint64_t periodNs = (uint64_t)LIST_STATS_DUMP_PERIOD_MS * 1000000ull;
+
+    uint64_t lastDumpNs = __atomic_load_n(&LastDumpNs, __ATOMIC_RELAXED);
+
+    if (lastDumpNs == 0)
+    {
+        //first record starts period
+        __atomic_compare_exchange_n(&LastDumpNs, &lastDumpNs, nowNs, false,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        return;
+    }
+
+    if (nowNs - lastDumpNs < periodNs)
+        return;
+
+    //only thread that moved period dumps
+    if (!__atomic_compare_exchange_n(&LastDumpNs, &lastDumpNs, nowNs, false,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        return;
+
+    ListStatsType stats = {};
+    ListGetGlobalStats(&stats);
+
+    ListStatsDump(&stats, "global");
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef LIST_STATS_H
+#define LIST_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// \file
+/// \brief Optional counters and latency histograms of list operations.
+/// \details Collected only if program is built with -D LIST_STATS, otherwise hooks
+///          expand to nothing and getters return zeros. Every list keeps own stats,
+///          global stats sum up all lists. All translation units have to be built
+///          with the same LIST_STATS setting, it changes ListType.
+
+static const size_t ListHistogramSubBucketBits = 3;
+static const size_t ListHistogramMaxExponent   = 40; ///< larger values go to last bucket
+static const size_t ListHistogramBucketsCount  =
+    (ListHistogramMaxExponent - ListHistogramSubBucketBits + 2) << ListHistogramSubBucketBits;
+
+/// @brief Log-linear histogram as in HdrHistogram, relative error is 1/8
+struct ListHistogramType
+{
+    uint64_t counts[ListHistogramBucketsCount];
+
+    uint64_t total;
+    uint64_t maxValue;
+};
+
+struct ListStatsType
+{
+    uint64_t inserts;
+    uint64_t erases;
+
+    uint64_t freeHeadAllocs;    ///< slots taken from head of free blocks
+    uint64_t nearAnchorAllocs;  ///< slots found near anchor by NEAR_ANCHOR policy
+
+    uint64_t capacityIncreases;
+    uint64_t capacityDecreases;
+    uint64_t rebuilds;
+    uint64_t bytesReallocated;
+
+    uint64_t verifies;
+    uint64_t verifyNs;
+
+    ListHistogramType insertNs;
+    ListHistogramType eraseNs;
+};
+
+struct ListType;
+
+/// @brief Copies stats of list
+void ListGetStats      (const ListType* list, ListStatsType* stats);
+void ListGetGlobalStats(ListStatsType* stats);
+
+/// @brief Adds value to histogram, not thread safe
+void     ListHistogramAdd       (ListHistogramType* histogram, const uint64_t value);
+
+/// @brief Upper bound of value below which given share (0..1) of recorded values are
+uint64_t ListHistogramPercentile(const ListHistogramType* histogram, const double share);
+
+/// @brief Prints counters and insert/erase percentiles to log
+void ListStatsDump(const ListStatsType* stats, const char* name);
+
+#ifdef LIST_STATS
+
+/// global stats are dumped to log not more often than once a period
+#ifndef LIST_STATS_DUMP_PERIOD_MS
+#define LIST_STATS_DUMP_PERIOD_MS 10000
+#endif
+
+uint64_t ListStatsNow();
+
+void ListStatsAdd   (ListType* list, uint64_t ListStatsType::* counter, const uint64_t value);
+void ListStatsRecord(ListType* list, ListHistogramType ListStatsType::* histogram,
+                                     const uint64_t beginNs);
+
+#define LIST_STATS_ADD(list, counter, value) \
+    ListStatsAdd((list), &ListStatsType::counter, (value))
+
+#define LIST_STATS_TIMER_BEGIN(name) const uint64_t name = ListStatsNow()
+
+#define LIST_STATS_RECORD(list, histogram, beginNs) \
+    ListStatsRecord((list), &ListStatsType::histogram, (beginNs))
+
+#define LIST_STATS_ADD_ELAPSED(list, counter, beginNs) \
+    ListStatsAdd((list), &ListStatsType::counter, ListStatsNow() - (beginNs))
+
+#else
+
+#define LIST_STATS_ADD(list, counter, value) do {} while (0)
+#define LIST_STATS_TIMER_BEGIN(name)         do {} while (0)
+#define LIST_STATS_RECORD(list, histogram, beginNs) do {} while (0)
+#define LIST_STATS_ADD_ELAPSED(list, counter, beginNs) do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,325 @@
+#include <assert.h>
+#include <string.h>
+
+#include "ListTrace.h"
+
+static const char    TraceMagic[]  = "LTRC";
+static const uint8_t TraceVersion  = 2;
+
+static const size_t  VarintMaxSize    = 10;
+static const size_t  RecordMaxSize    = 1 + 3 * VarintMaxSize;
+
+static inline void TraceFlush    (ListTraceType* trace);
+static inline void TracePutByte  (ListTraceType* trace, const uint8_t byte);
+static inline void TracePutVarint(ListTraceType* trace, uint64_t value);
+
+static inline bool ReaderGetByte  (ListTraceReaderType* reader, uint8_t* byte);
+static inline bool ReaderGetVarint(ListTraceReaderType* reader, uint64_t* value);
+
+static inline uint64_t ZigzagEncode(const int value);
+static inline int      ZigzagDecode(const uint64_t value);
+
+ListErrors ListTraceStart(ListType* list, const char* fileName)
+{
+    assert(list);
+    assert(fileName);
+
+    ListTraceStop(list);
+
+    ListTraceType* trace = (ListTraceType*) list->allocator.allocFunc(list->allocator.context,
+                                                                      sizeof(*trace),
+                                                                      alignof(ListTraceType));
+
+    if (trace == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    trace->file = fopen(fileName, "wb");
+
+    if (trace->file == nullptr)
+    {
+        list->allocator.freeFunc(list->allocator.context, trace, sizeof(*trace));
+        return ListErrors::FILE_ERR;
+    }
+
+    trace->bufferSize   = 0;
+    trace->recordsCount = 0;
+
+    for (size_t i = 0; i + 1 < sizeof(TraceMagic); ++i)
+        TracePutByte(trace, (uint8_t)TraceMagic[i]);
+
+    TracePutByte(trace, TraceVersion);
+
+    list->trace = trace;
+
+    ListTraceSnapshot(list);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListTraceStop(ListType* list)
+{
+    assert(list);
+
+    ListTraceType* trace = list->trace;
+
+    if (trace == nullptr)
+        return ListErrors::NO_ERR;
+
+    TraceFlush(trace);
+
+    const bool isWritten = !ferror(trace->file);
+
+    fclose(trace->file);
+
+    list->allocator.freeFunc(list->allocator.context, trace, sizeof(*trace));
+    list->trace = nullptr;
+
+    return isWritten ? ListErrors::NO_ERR : ListErrors::FILE_ERR;
+}
+
+void ListTraceRecord(ListType* list, const ListTraceOp op, const size_t pos,
+                     const size_t anchorPos, const int value)
+{
+    assert(list);
+    assert(list->trace);
+
+    ListTraceType* trace = list->trace;
+
+    if (trace->bufferSize + RecordMaxSize > ListTraceBufferSize)
+        TraceFlush(trace);
+
+    TracePutByte(trace, (uint8_t)op);
+
+    switch (op)
+    {
+        case ListTraceOp::INSERT:
+            TracePutVarint(trace, pos);
+            TracePutVarint(trace, anchorPos);
+            TracePutVarint(trace, ZigzagEncode(value));
+            break;
+
+        case ListTraceOp::MOVE:
+            TracePutVarint(trace, pos);
+            TracePutVarint(trace, anchorPos);
+            break;
+
+        case ListTraceOp::SET:
+            TracePutVarint(trace, pos);
+            TracePutVarint(trace, ZigzagEncode(value));
+            break;
+
+        case ListTraceOp::ERASE:
+        case ListTraceOp::DETACH:
+        case ListTraceOp::RELEASE:
+        case ListTraceOp::GET:
+            TracePutVarint(trace, pos);
+            break;
+
+        case ListTraceOp::CLEAR:
+        case ListTraceOp::SNAPSHOT_END:
+        default:
+            break;
+    }
+
+    trace->recordsCount++;
+}
+
+void ListTraceSnapshot(ListType* list)
+{
+    assert(list);
+    assert(list->trace);
+
+    ListTraceRecord(list, ListTraceOp::CLEAR, 0);
+
+    for (size_t pos = ListGetHead(list); pos != list->end; pos = list->data[pos].nextPos)
+        ListTraceRecord(list, ListTraceOp::INSERT, pos, list->end, list->data[pos].value);
+
+    ListTraceRecord(list, ListTraceOp::SNAPSHOT_END, 0);
+}
+
+ListErrors ListTraceReaderOpen(ListTraceReaderType* reader, const char* fileName)
+{
+    assert(reader);
+    assert(fileName);
+
+    reader->file = fopen(fileName, "rb");
+
+    if (reader->file == nullptr)
+        return ListErrors::FILE_ERR;
+
+    reader->bufferSize = 0;
+    reader->bufferPos  = 0;
+
+    for (size_t i = 0; i + 1 < sizeof(TraceMagic); ++i)
+    {
+        uint8_t byte = 0;
+
+        if (!ReaderGetByte(reader, &byte) || byte != (uint8_t)TraceMagic[i])
+        {
+            ListTraceReaderClose(reader);
+            return ListErrors::INVALID_DATA;
+        }
+    }
+
+    uint8_t version = 0;
+
+    if (!ReaderGetByte(reader, &version) || version != TraceVersion)
+    {
+        ListTraceReaderClose(reader);
+        return ListErrors::INVALID_DATA;
+    }
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListTraceReaderClose(ListTraceReaderType* reader)
+{
+    assert(reader);
+
+    if (reader->file != nullptr)
+        fclose(reader->file);
+
+    reader->file = nullptr;
+
+    return ListErrors::NO_ERR;
+}
+
+bool ListTraceRead(ListTraceReaderType* reader, ListTraceRecordType* record)
+{
+    assert(reader);
+    assert(record);
+
+    uint8_t op = 0;
+
+    if (!ReaderGetByte(reader, &op))
+        return false;
+
+    record->op        = (ListTraceOp)op;
+    record->pos       = 0;
+    record->anchorPos = 0;
+    record->value     = 0;
+
+    uint64_t pos = 0, anchorPos = 0, value = 0;
+    bool isRead = true;
+
+    switch (record->op)
+    {
+        case ListTraceOp::INSERT:
+            isRead = ReaderGetVarint(reader, &pos) && ReaderGetVarint(reader, &anchorPos) &&
+                     ReaderGetVarint(reader, &value);
+            break;
+
+        case ListTraceOp::MOVE:
+            isRead = ReaderGetVarint(reader, &pos) && ReaderGetVarint(reader, &anchorPos);
+            break;
+
+        case ListTraceOp::SET:
+            isRead = ReaderGetVarint(reader, &pos) && ReaderGetVarint(reader, &value);
+            break;
+
+        case ListTraceOp::ERASE:
+        case ListTraceOp::DETACH:
+        case ListTraceOp::RELEASE:
+        case ListTraceOp::GET:
+            isRead = ReaderGetVarint(reader, &pos);
+            break;
+
+        case ListTraceOp::CLEAR:
+        case ListTraceOp::SNAPSHOT_END:
+            break;
+
+        default:
+            return false;
+    }
+
+    record->pos       = pos;
+    record->anchorPos = anchorPos;
+    record->value     = ZigzagDecode(value);
+
+    return isRead;
+}
+
+static inline void TraceFlush(ListTraceType* trace)
+{
+    assert(trace);
+
+    if (trace->bufferSize != 0)
+        fwrite(trace->buffer, 1, trace->bufferSize, trace->file);
+
+    trace->bufferSize = 0;
+}
+
+static inline void TracePutByte(ListTraceType* trace, const uint8_t byte)
+{
+    assert(trace);
+    assert(trace->bufferSize < ListTraceBufferSize);
+
+    trace->buffer[trace->bufferSize++] = byte;
+}
+
+static inline void TracePutVarint(ListTraceType* trace, uint64_t value)
+{
+    assert(trace);
+
+    //7 bits per byte, high bit is set on all bytes but last
+    while (value >= 0x80)
+    {
+        TracePutByte(trace, (uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+
+    TracePutByte(trace, (uint8_t)value);
+}
+
+static inline bool ReaderGetByte(ListTraceReaderType* reader, uint8_t* byte)
+{
+    assert(reader);
+    assert(byte);
+
+    if (reader->bufferPos == reader->bufferSize)
+    {
+        reader->bufferSize = fread(reader->buffer, 1, ListTraceBufferSize, reader->file);
+        reader->bufferPos  = 0;
+
+        if (reader->bufferSize == 0)
+            return false;
+    }
+
+    *byte = reader->buffer[reader->bufferPos++];
+
+    return true;
+}
+
+static inline bool ReaderGetVarint(ListTraceReaderType* reader, uint64_t* value)
+{
+    assert(reader);
+    assert(value);
+
+    *value = 0;
+
+    for (size_t shift = 0; shift < 7 * VarintMaxSize; shift += 7)
+    {
+        uint8_t byte = 0;
+
+        if (!ReaderGetByte(reader, &byte))
+            return false;
+
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+static inline uint64_t ZigzagEncode(const int value)
+{
+    //small negative values get short codes too
+    return ((uint64_t)(int64_t)value << 1) ^ (uint64_t)((int64_t)value >> 63);
+}
+
+static inline int ZigzagDecode(const uint64_t value)
+{
+    return (int)(int64_t)((value >> 1) ^ (~(value & 1) + 1));
+}
@@ -0,0 +1,86 @@
+#ifndef LIST_TRACE_H
+#define LIST_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "List.h"
+
+/// \file
+/// \brief Opt-in recorder of list operations into compact binary trace and its reader.
+/// \details Trace is "LTRC" and version byte followed by records: operation byte and
+///          LEB128 varints of positions, values are zigzag encoded. Recording starts
+///          with snapshot of list, and operations moving elements to other slots (sort,
+///          rebuild) write snapshot again, so positions of trace can always be mapped
+///          to positions of list replaying it. Snapshot is CLEAR, INSERT records and
+///          SNAPSHOT_END, so replay can tell its inserts from measured ones. Replay is
+///          made by ListReplay tool.
+
+enum class ListTraceOp : uint8_t
+{
+    INSERT = 1, ///< pos is new position, anchorPos is anchor
+    ERASE,
+    DETACH,
+    RELEASE,
+    MOVE,       ///< pos is moved before anchorPos
+    GET,
+    SET,
+    CLEAR,      ///< snapshot begins: list is emptied, INSERT records before end follow
+    SNAPSHOT_END,
+};
+
+struct ListTraceRecordType
+{
+    ListTraceOp op;
+
+    size_t pos;
+    size_t anchorPos;
+    int    value;
+};
+
+static const size_t ListTraceBufferSize = 4096;
+
+struct ListTraceType
+{
+    FILE* file;
+
+    uint8_t buffer[ListTraceBufferSize];
+    size_t  bufferSize;
+
+    uint64_t recordsCount;
+};
+
+/// @brief Starts recording list operations to file, snapshot of list is written first
+ListErrors ListTraceStart(ListType* list, const char* fileName);
+
+/// @brief Flushes trace and stops recording, called by ListDtor too
+ListErrors ListTraceStop (ListType* list);
+
+//-------Called by list on its changes---------
+
+void ListTraceRecord  (ListType* list, const ListTraceOp op, const size_t pos,
+                       const size_t anchorPos = 0, const int value = 0);
+
+/// @brief Writes snapshot after elements moved to other slots
+void ListTraceSnapshot(ListType* list);
+
+//-------Reading---------
+
+struct ListTraceReaderType
+{
+    FILE* file;
+
+    uint8_t buffer[ListTraceBufferSize];
+    size_t  bufferSize;
+    size_t  bufferPos;
+};
+
+ListErrors ListTraceReaderOpen (ListTraceReaderType* reader, const char* fileName);
+ListErrors ListTraceReaderClose(ListTraceReaderType* reader);
+
+/// @brief Reads next record
+/// @return false at end of trace or on broken record
+bool ListTraceRead(ListTraceReaderType* reader, ListTraceRecordType* record);
+
+#endif
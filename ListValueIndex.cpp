@@ -0,0 +1,250 @@
+#include <assert.h>
+#include <string.h>
+
+#include "ListValueIndex.h"
+
+static const size_t ValueIndexMinCapacity = 16;
+
+static inline size_t Hash      (const int value);
+static inline void   EntryAdd  (ListValueIndexType* index, const int value, const size_t pos);
+static        void   EntryErase(ListValueIndexType* index, const int value, const size_t pos);
+
+static ListErrors TableResize(ListType* list, const size_t newCapacity);
+
+ListErrors ListValueIndexEnable(ListType* list)
+{
+    assert(list);
+
+    if (list->valueIndex != nullptr)
+        return ListErrors::NO_ERR;
+
+    ListValueIndexType* index = (ListValueIndexType*) list->allocator.allocFunc(
+                                                            list->allocator.context,
+                                                            sizeof(*index),
+                                                            alignof(ListValueIndexType));
+
+    if (index == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    index->entries  = nullptr;
+    index->capacity = 0;
+    index->count    = 0;
+
+    list->valueIndex = index;
+
+    ListErrors error = ListValueIndexRebuild(list);
+
+    if (error != ListErrors::NO_ERR)
+        ListValueIndexDisable(list);
+
+    return error;
+}
+
+ListErrors ListValueIndexDisable(ListType* list)
+{
+    assert(list);
+
+    ListValueIndexType* index = list->valueIndex;
+
+    if (index == nullptr)
+        return ListErrors::NO_ERR;
+
+    if (index->entries != nullptr)
+        list->allocator.freeFunc(list->allocator.context, index->entries,
+                                 index->capacity * sizeof(*index->entries));
+
+    list->allocator.freeFunc(list->allocator.context, index, sizeof(*index));
+
+    list->valueIndex = nullptr;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors ListFind(ListType* list, const int value, size_t* pos)
+{
+    assert(list);
+    assert(pos);
+
+    ListValueIndexType* index = list->valueIndex;
+
+    if (index == nullptr)
+    {
+        for (size_t i = ListGetHead(list); i != list->end; i = list->data[i].nextPos)
+        {
+            if (list->data[i].value == value)
+            {
+                *pos = i;
+                return ListErrors::NO_ERR;
+            }
+        }
+
+        return ListErrors::VALUE_NOT_FOUND;
+    }
+
+    const size_t mask = index->capacity - 1;
+
+    for (size_t i = Hash(value) & mask; index->entries[i].pos != 0; i = (i + 1) & mask)
+    {
+        if (index->entries[i].value == value)
+        {
+            *pos = index->entries[i].pos;
+            return ListErrors::NO_ERR;
+        }
+    }
+
+    return ListErrors::VALUE_NOT_FOUND;
+}
+
+ListErrors ListValueIndexReserve(ListType* list, const size_t count)
+{
+    assert(list);
+
+    ListValueIndexType* index = list->valueIndex;
+    assert(index);
+
+    //load factor is kept at most 1/2, probe sequences stay short
+    if (index->capacity != 0 && count * 2 <= index->capacity)
+        return ListErrors::NO_ERR;
+
+    size_t newCapacity = index->capacity == 0 ? ValueIndexMinCapacity : index->capacity;
+    while (count * 2 > newCapacity)
+        newCapacity *= 2;
+
+    return TableResize(list, newCapacity);
+}
+
+void ListValueIndexOnInsert(ListType* list, const size_t pos)
+{
+    assert(list);
+    assert(list->valueIndex);
+    assert((list->valueIndex->count + 1) * 2 <= list->valueIndex->capacity);
+
+    EntryAdd(list->valueIndex, list->data[pos].value, pos);
+}
+
+void ListValueIndexOnErase(ListType* list, const size_t pos)
+{
+    assert(list);
+    assert(list->valueIndex);
+
+    EntryErase(list->valueIndex, list->data[pos].value, pos);
+}
+
+ListErrors ListValueIndexRebuild(ListType* list)
+{
+    assert(list);
+
+    ListValueIndexType* index = list->valueIndex;
+    assert(index);
+
+    ListErrors error = ListValueIndexReserve(list, list->size);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    memset(index->entries, 0, index->capacity * sizeof(*index->entries));
+    index->count = 0;
+
+    for (size_t i = ListGetHead(list); i != list->end; i = list->data[i].nextPos)
+        EntryAdd(index, list->data[i].value, i);
+
+    return ListErrors::NO_ERR;
+}
+
+static ListErrors TableResize(ListType* list, const size_t newCapacity)
+{
+    assert(list);
+
+    ListValueIndexType* index = list->valueIndex;
+    assert(index);
+
+    ListValueEntryType* newEntries = (ListValueEntryType*) list->allocator.allocFunc(
+                                                            list->allocator.context,
+                                                            newCapacity * sizeof(*newEntries),
+                                                            alignof(ListValueEntryType));
+
+    if (newEntries == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    memset(newEntries, 0, newCapacity * sizeof(*newEntries));
+
+    ListValueEntryType* oldEntries  = index->entries;
+    const size_t        oldCapacity = index->capacity;
+
+    index->entries  = newEntries;
+    index->capacity = newCapacity;
+    index->count    = 0;
+
+    for (size_t i = 0; i < oldCapacity; ++i)
+    {
+        if (oldEntries[i].pos != 0)
+            EntryAdd(index, oldEntries[i].value, oldEntries[i].pos);
+    }
+
+    if (oldEntries != nullptr)
+        list->allocator.freeFunc(list->allocator.context, oldEntries,
+                                 oldCapacity * sizeof(*oldEntries));
+
+    return ListErrors::NO_ERR;
+}
+
+static inline void EntryAdd(ListValueIndexType* index, const int value, const size_t pos)
+{
+    assert(index);
+    assert(pos != 0);
+
+    const size_t mask = index->capacity - 1;
+
+    size_t i = Hash(value) & mask;
+    while (index->entries[i].pos != 0)
+        i = (i + 1) & mask;
+
+    index->entries[i].pos   = pos;
+    index->entries[i].value = value;
+
+    index->count++;
+}
+
+static void EntryErase(ListValueIndexType* index, const int value, const size_t pos)
+{
+    assert(index);
+
+    const size_t mask = index->capacity - 1;
+
+    size_t hole = Hash(value) & mask;
+    while (index->entries[hole].pos != pos)
+    {
+        assert(index->entries[hole].pos != 0);
+        hole = (hole + 1) & mask;
+    }
+
+    //backward shift: entries of the probe run that can not be found past hole move into it
+    for (size_t i = (hole + 1) & mask; index->entries[i].pos != 0; i = (i + 1) & mask)
+    {
+        const size_t home = Hash(index->entries[i].value) & mask;
+
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            index->entries[hole] = index->entries[i];
+            hole = i;
+        }
+    }
+
+    index->entries[hole].pos = 0;
+
+    index->count--;
+}
+
+static inline size_t Hash(const int value)
+{
+    //murmur3 finalizer, consecutive ids spread over the table
+    uint32_t hash = (uint32_t)value;
+
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+
+    return hash;
+}
@@ -0,0 +1,52 @@
+#ifndef LIST_VALUE_INDEX_H
+#define LIST_VALUE_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "List.h"
+
+/// \file
+/// \brief Optional hash index from values to list slots.
+/// \details Open addressing with linear probing, entries are stored in one array,
+///          erased entries are removed by backward shift so there are no tombstones.
+///          Equal values get separate entries. Maintained by List.cpp on every insert,
+///          erase and change of value, O(1) on average.
+
+struct ListValueEntryType
+{
+    size_t pos;     ///< 0 if entry is empty
+    int    value;
+};
+
+struct ListValueIndexType
+{
+    ListValueEntryType* entries;
+    size_t              capacity;   ///< power of 2
+
+    size_t count;
+};
+
+ListErrors ListValueIndexEnable (ListType* list);
+ListErrors ListValueIndexDisable(ListType* list);
+
+/// @brief Finds position of some element with value
+/// @details O(1) on average with value index, walks the list without it.
+///          Returns VALUE_NOT_FOUND if there is no such element.
+ListErrors ListFind(ListType* list, const int value, size_t* pos);
+
+//-------Called by list on its changes---------
+
+/// @brief Makes index able to keep count entries, called before insert
+ListErrors ListValueIndexReserve (ListType* list, const size_t count);
+
+/// @brief Adds element already written to pos
+void       ListValueIndexOnInsert(ListType* list, const size_t pos);
+
+/// @brief Removes element, called while value at pos is still there
+void       ListValueIndexOnErase (ListType* list, const size_t pos);
+
+/// @brief Builds index again after positions of many elements changed
+ListErrors ListValueIndexRebuild (ListType* list);
+
+#endif
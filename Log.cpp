@@ -7,10 +7,15 @@
 #include <unistd.h>
 #include <fcntl.h>
 
+#include <mutex>
+
 #include "Log.h"
 
 static int LOG_FILE;
 
+/// recursive, because log parts call Log inside; error thread logs concurrently
+static std::recursive_mutex LogMutex;
+
 static inline void PrintSeparator();
 static void LogClose();
 
@@ -40,6 +45,8 @@ void LogOpen(const char* argv0)
 
 static void LogClose()
 {
+    std::lock_guard<std::recursive_mutex> lock(LogMutex);
+
     if (LOG_FILE == -1)
         return;
     time_t timeInSeconds = time(nullptr);
@@ -63,6 +70,8 @@ void LogBegin(const char* fileName, const char* funcName, const int line)
     assert(fileName);
     assert(funcName);
 
+    std::lock_guard<std::recursive_mutex> lock(LogMutex);
+
     if (LOG_FILE == -1)
         return;
 
@@ -86,6 +95,8 @@ ssize_t Log(const char* format, ...)
 {
     assert(format);
 
+    std::lock_guard<std::recursive_mutex> lock(LogMutex);
+
     va_list args = {};
 
     va_start(args, format);
@@ -104,6 +115,8 @@ ssize_t Log(const char* format, ...)
 
 void LogEnd(const char* fileName, const char* funcName, const int line)
 {
+    std::lock_guard<std::recursive_mutex> lock(LogMutex);
+
     static const size_t buffSize = 128;
     static void* buffer[buffSize];
     int numb = backtrace(buffer, buffSize);
@@ -133,8 +146,13 @@ static inline size_t Min(size_t a, size_t b)
 static int TryOpenFile(const char* name)
 {
     //TODO: поменять на статический массив, а то calloc в логах странно
-    char* newString = strdup(name);
-    char* fileName  = strcat(newString, ".log.html");
+    static const char extension[] = ".log.html";
+
+    char* newString = (char*)calloc(strlen(name) + sizeof(extension), sizeof(char));
+    if (newString == nullptr)
+        return -1;
+
+    char* fileName  = strcat(strcpy(newString, name), extension);
 
     LOG_FILE = open(fileName, O_WRONLY | O_APPEND);
 
@@ -0,0 +1,537 @@
+#include <assert.h>
+#include <string.h>
+
+#include "Log.h"
+#include "Errors.h"
+#include "UnrolledList.h"
+
+static const size_t UnrolledMinCapacity = 16;
+static const size_t BlockAlignment      = alignof(UnrolledBlockType);
+
+static inline void BlocksInit(UnrolledBlockType* data, const size_t leftBorder,
+                                                       const size_t rightBorder);
+
+static inline ListErrors BlocksCapacityIncrease(UnrolledListType* list);
+static inline ListErrors GetPosForNewBlock     (UnrolledListType* list, size_t* pos);
+static inline void       AddFreeBlock          (UnrolledListType* list, const size_t pos);
+
+static inline ListErrors LinkNewBlockAfter(UnrolledListType* list, const size_t prevBlock,
+                                                                   size_t* newBlock);
+static inline void       UnlinkBlock      (UnrolledListType* list, const size_t block);
+
+static inline void SplitBlock(UnrolledListType* list, const size_t block,
+                                                      const size_t newBlock);
+static inline void MergeWithNext(UnrolledListType* list, const size_t block);
+
+static inline void UnrolledErrorPayloadInit(const UnrolledListType* list,
+                                            ErrorPayloadType* payload);
+static        void UnrolledErrorFormat     (const int code, const ErrorPayloadType* payload);
+
+//dumps are too slow for error bursts, snapshot is logged later by error thread
+#define UNROLLED_LIST_CHECK(list)                                   \
+do                                                                  \
+{                                                                   \
+    ListErrors listErr = UnrolledListVerify(list);                  \
+                                                                    \
+    if (listErr != ListErrors::NO_ERR)                              \
+    {                                                               \
+        ErrorPayloadType errorPayload = {};                         \
+        UnrolledErrorPayloadInit(list, &errorPayload);              \
+        ERROR_RECORD(listErr, &errorPayload, UnrolledErrorFormat);  \
+        return listErr;                                             \
+    }                                                               \
+} while (0)
+
+ListErrors UnrolledListCtor(UnrolledListType* list, const size_t listStandardCapacity,
+                            const ListAllocatorType* allocator)
+{
+    assert(list);
+
+    size_t capacity = listStandardCapacity;
+    if (capacity < UnrolledMinCapacity)
+        capacity = UnrolledMinCapacity;
+
+    list->allocator = allocator ? *allocator : ListStandardAllocator();
+
+    list->data = (UnrolledBlockType*) list->allocator.allocFunc(list->allocator.context,
+                                                                capacity * sizeof(*list->data),
+                                                                BlockAlignment);
+
+    if (list->data == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    list->capacity    = capacity;
+    list->size        = 0;
+    list->blocksCount = 0;
+
+    list->data[0].prevPos = list->data[0].nextPos = 0;
+    list->data[0].count   = 0;
+
+    BlocksInit(list->data, 1, list->capacity);
+
+    list->end           = 0;
+    list->freeBlockHead = 1;
+
+    UNROLLED_LIST_CHECK(list);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors UnrolledListDtor(UnrolledListType* list)
+{
+    assert(list);
+
+    if (list->data != nullptr)
+        list->allocator.freeFunc(list->allocator.context, list->data,
+                                 list->capacity * sizeof(*list->data));
+
+    list->end = list->freeBlockHead = 0;
+    list->capacity = list->size = list->blocksCount = 0;
+
+    list->data = nullptr;
+    return ListErrors::NO_ERR;
+}
+
+ListErrors UnrolledListVerify(UnrolledListType* list)
+{
+    assert(list);
+
+    if (list->data == nullptr)
+        return ListErrors::DATA_IS_NULLPTR;
+
+    if (list->capacity <= list->blocksCount)
+        return ListErrors::OUT_OF_RANGE;
+
+    if (list->blocksCount * UnrolledBlockCapacity < list->size)
+        return ListErrors::INVALID_DATA;
+
+    if (list->data[list->end].count != 0)
+        return ListErrors::INVALID_NULLPTR;
+
+    if (list->freeBlockHead >= list->capacity)
+        return ListErrors::OUT_OF_RANGE;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors UnrolledListInsert(UnrolledListType* list, const UnrolledListPosType anchorPos,
+                              const int value, UnrolledListPosType* insertedValPos)
+{
+    assert(list);
+    assert(insertedValPos);
+    assert(anchorPos.block < list->capacity);
+
+    UNROLLED_LIST_CHECK(list);
+
+    size_t block = anchorPos.block;
+    size_t index = anchorPos.index;
+
+    if (block == list->end)
+    {
+        //pushing back, tail block is filled first
+        block = list->data[list->end].prevPos;
+
+        if (block == list->end || list->data[block].count == (int)UnrolledBlockCapacity)
+        {
+            ListErrors error = LinkNewBlockAfter(list, block, &block);
+
+            if (error != ListErrors::NO_ERR)
+                return error;
+        }
+
+        index = (size_t)list->data[block].count;
+    }
+    else if (list->data[block].count == (int)UnrolledBlockCapacity)
+    {
+        size_t newBlock = 0;
+        ListErrors error = LinkNewBlockAfter(list, block, &newBlock);
+
+        if (error != ListErrors::NO_ERR)
+            return error;
+
+        SplitBlock(list, block, newBlock);
+
+        if (index > (size_t)list->data[block].count)
+        {
+            index -= (size_t)list->data[block].count;
+            block  = newBlock;
+        }
+    }
+
+    assert(index <= (size_t)list->data[block].count);
+
+    UnrolledBlockType* blockPtr = &list->data[block];
+
+    memmove(blockPtr->values + index + 1, blockPtr->values + index,
+            ((size_t)blockPtr->count - index) * sizeof(*blockPtr->values));
+
+    blockPtr->values[index] = value;
+    blockPtr->count++;
+
+    list->size++;
+
+    *insertedValPos = { block, index };
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors UnrolledListErase(UnrolledListType* list, const UnrolledListPosType pos,
+                             UnrolledListPosType* nextValPos)
+{
+    assert(list);
+    assert(pos.block != list->end && pos.block < list->capacity);
+    assert(pos.index < (size_t)list->data[pos.block].count);
+
+    UNROLLED_LIST_CHECK(list);
+
+    const size_t block = pos.block;
+    const size_t index = pos.index;
+
+    UnrolledBlockType* blockPtr = &list->data[block];
+
+    memmove(blockPtr->values + index, blockPtr->values + index + 1,
+            ((size_t)blockPtr->count - index - 1) * sizeof(*blockPtr->values));
+
+    blockPtr->count--;
+    list->size--;
+
+    UnrolledListPosType nextPos = { block, index };
+
+    if (blockPtr->count == 0)
+    {
+        nextPos = { blockPtr->nextPos, 0 };
+        UnlinkBlock(list, block);
+    }
+    else
+    {
+        const size_t nextBlock = blockPtr->nextPos;
+
+        if (nextBlock != list->end && (size_t)blockPtr->count < UnrolledBlockCapacity / 2 &&
+            (size_t)(blockPtr->count + list->data[nextBlock].count) <= UnrolledBlockCapacity)
+        {
+            MergeWithNext(list, block);
+        }
+
+        if (index == (size_t)blockPtr->count)
+            nextPos = { blockPtr->nextPos, 0 };
+    }
+
+    if (nextValPos)
+        *nextValPos = nextPos;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors UnrolledListGetElemValue(UnrolledListType* list, UnrolledListPosType pos,
+                                    int* elemValue)
+{
+    assert(list);
+    assert(elemValue);
+
+    if (pos.block == list->end)
+        return ListErrors::TRYING_TO_GET_NULL_ELEMENT;
+
+    UNROLLED_LIST_CHECK(list);
+
+    assert(pos.index < (size_t)list->data[pos.block].count);
+
+    *elemValue = list->data[pos.block].values[pos.index];
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors UnrolledListSetElemValue(UnrolledListType* list, UnrolledListPosType pos,
+                                    int newElemValue)
+{
+    assert(list);
+
+    if (pos.block == list->end)
+        return ListErrors::TRYING_TO_CHANGE_NULL_ELEMENT;
+
+    UNROLLED_LIST_CHECK(list);
+
+    assert(pos.index < (size_t)list->data[pos.block].count);
+
+    list->data[pos.block].values[pos.index] = newElemValue;
+
+    return ListErrors::NO_ERR;
+}
+
+UnrolledListPosType UnrolledListGetHead(const UnrolledListType* list)
+{
+    assert(list);
+
+    return { list->data[list->end].nextPos, 0 };
+}
+
+UnrolledListPosType UnrolledListGetTail(const UnrolledListType* list)
+{
+    assert(list);
+
+    const size_t tailBlock = list->data[list->end].prevPos;
+
+    if (tailBlock == list->end)
+        return { list->end, 0 };
+
+    return { tailBlock, (size_t)list->data[tailBlock].count - 1 };
+}
+
+UnrolledListPosType UnrolledListGetEnd(const UnrolledListType* list)
+{
+    assert(list);
+
+    return { list->end, 0 };
+}
+
+UnrolledListPosType UnrolledListGetNextElem(const UnrolledListType* list,
+                                            const UnrolledListPosType pos)
+{
+    assert(list);
+
+    if (pos.index + 1 < (size_t)list->data[pos.block].count)
+        return { pos.block, pos.index + 1 };
+
+    return { list->data[pos.block].nextPos, 0 };
+}
+
+UnrolledListPosType UnrolledListGetPrevElem(const UnrolledListType* list,
+                                            const UnrolledListPosType pos)
+{
+    assert(list);
+
+    if (pos.block != list->end && pos.index > 0)
+        return { pos.block, pos.index - 1 };
+
+    const size_t prevBlock = list->data[pos.block].prevPos;
+
+    if (prevBlock == list->end)
+        return { list->end, 0 };
+
+    return { prevBlock, (size_t)list->data[prevBlock].count - 1 };
+}
+
+bool UnrolledListPosIsEnd(const UnrolledListType* list, const UnrolledListPosType pos)
+{
+    assert(list);
+
+    return pos.block == list->end;
+}
+
+static inline void UnrolledErrorPayloadInit(const UnrolledListType* list,
+                                            ErrorPayloadType* payload)
+{
+    assert(list);
+    assert(payload);
+
+    //only list fields are copied, blocks may be broken
+    payload->words[0] = (uint64_t)list->data;
+    payload->words[1] = list->end;
+    payload->words[2] = list->freeBlockHead;
+    payload->words[3] = list->size;
+    payload->words[4] = list->blocksCount;
+    payload->words[5] = list->capacity;
+}
+
+static void UnrolledErrorFormat(const int code, const ErrorPayloadType* payload)
+{
+    Log("%s", ListErrorsGetMessage((ListErrors)code));
+
+    if (payload == nullptr)
+        return;
+
+    Log("Unrolled list data: %p, end: %llu, free blocks head: %llu, size: %llu, "
+        "blocks: %llu, capacity: %llu\n", (void*)payload->words[0],
+        (unsigned long long)payload->words[1], (unsigned long long)payload->words[2],
+        (unsigned long long)payload->words[3], (unsigned long long)payload->words[4],
+        (unsigned long long)payload->words[5]);
+}
+
+void UnrolledListTextDump(const UnrolledListType* list, const char* fileName,
+                                                        const char* funcName,
+                                                        const int   line)
+{
+    assert(list);
+    assert(fileName);
+    assert(funcName);
+
+    LogBegin(fileName, funcName, line);
+
+    Log("Free blocks head: %zu\n", list->freeBlockHead);
+
+    Log("List capacity    : %zu\n", list->capacity);
+    Log("List blocks count: %zu\n", list->blocksCount);
+    Log("List size        : %zu\n", list->size);
+
+    Log("Data[%p]:\n", list->data);
+
+    if (list->data == nullptr)
+    {
+        LOG_END();
+        return;
+    }
+
+    Log("List:\n");
+
+    for (size_t i = list->data[list->end].nextPos; i != list->end; i = list->data[i].nextPos)
+    {
+        Log("\tBlock id: %zu, count: %d, previous position: %zu, next position: %zu\n\t\t",
+            i, list->data[i].count, list->data[i].prevPos, list->data[i].nextPos);
+
+        for (int j = 0; j < list->data[i].count; ++j)
+            Log("%d ", list->data[i].values[j]);
+
+        Log("\n");
+    }
+
+    LOG_END();
+}
+
+static inline void BlocksInit(UnrolledBlockType* data, const size_t leftBorder,
+                                                       const size_t rightBorder)
+{
+    assert(data);
+    assert(leftBorder != 0);
+    assert(leftBorder < rightBorder);
+
+    for (size_t i = leftBorder; i < rightBorder; ++i)
+    {
+        data[i].prevPos = 0;
+        data[i].nextPos = i + 1;
+        data[i].count   = 0;
+    }
+
+    data[rightBorder - 1].nextPos = 0;
+}
+
+static inline ListErrors BlocksCapacityIncrease(UnrolledListType* list)
+{
+    assert(list);
+    assert(list->freeBlockHead == 0);
+
+    const size_t newCapacity = list->capacity * 2;
+
+    void* tmpPtr = list->allocator.reallocFunc(list->allocator.context, list->data,
+                                               list->capacity * sizeof(*list->data),
+                                               newCapacity    * sizeof(*list->data),
+                                               BlockAlignment);
+
+    if (tmpPtr == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    list->data = (UnrolledBlockType*)tmpPtr;
+
+    BlocksInit(list->data, list->capacity, newCapacity);
+
+    list->freeBlockHead = list->capacity;
+    list->capacity      = newCapacity;
+
+    return ListErrors::NO_ERR;
+}
+
+static inline ListErrors GetPosForNewBlock(UnrolledListType* list, size_t* pos)
+{
+    assert(list);
+    assert(pos);
+
+    ListErrors error = ListErrors::NO_ERR;
+    if (list->freeBlockHead == 0)
+        error = BlocksCapacityIncrease(list);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    *pos = list->freeBlockHead;
+    list->freeBlockHead = list->data[list->freeBlockHead].nextPos;
+
+    list->blocksCount++;
+
+    return ListErrors::NO_ERR;
+}
+
+static inline void AddFreeBlock(UnrolledListType* list, const size_t pos)
+{
+    assert(list);
+    assert(pos != list->end && pos < list->capacity);
+
+    list->data[pos].prevPos = 0;
+    list->data[pos].nextPos = list->freeBlockHead;
+    list->data[pos].count   = 0;
+
+    list->freeBlockHead = pos;
+
+    list->blocksCount--;
+}
+
+static inline ListErrors LinkNewBlockAfter(UnrolledListType* list, const size_t prevBlock,
+                                                                   size_t* newBlock)
+{
+    assert(list);
+    assert(newBlock);
+
+    size_t block = 0;
+    ListErrors error = GetPosForNewBlock(list, &block);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    const size_t nextBlock = list->data[prevBlock].nextPos;
+
+    list->data[block].prevPos = prevBlock;
+    list->data[block].nextPos = nextBlock;
+    list->data[block].count   = 0;
+
+    list->data[prevBlock].nextPos = block;
+    list->data[nextBlock].prevPos = block;
+
+    *newBlock = block;
+
+    return ListErrors::NO_ERR;
+}
+
+static inline void UnlinkBlock(UnrolledListType* list, const size_t block)
+{
+    assert(list);
+
+    list->data[list->data[block].prevPos].nextPos = list->data[block].nextPos;
+    list->data[list->data[block].nextPos].prevPos = list->data[block].prevPos;
+
+    AddFreeBlock(list, block);
+}
+
+static inline void SplitBlock(UnrolledListType* list, const size_t block,
+                                                      const size_t newBlock)
+{
+    assert(list);
+    assert(list->data[newBlock].count == 0);
+
+    UnrolledBlockType* blockPtr    = &list->data[block];
+    UnrolledBlockType* newBlockPtr = &list->data[newBlock];
+
+    const int keptCount  = blockPtr->count / 2;
+    const int movedCount = blockPtr->count - keptCount;
+
+    memcpy(newBlockPtr->values, blockPtr->values + keptCount,
+           (size_t)movedCount * sizeof(*blockPtr->values));
+
+    newBlockPtr->count = movedCount;
+    blockPtr->count    = keptCount;
+}
+
+static inline void MergeWithNext(UnrolledListType* list, const size_t block)
+{
+    assert(list);
+
+    UnrolledBlockType* blockPtr = &list->data[block];
+
+    const size_t       nextBlock    = blockPtr->nextPos;
+    UnrolledBlockType* nextBlockPtr = &list->data[nextBlock];
+
+    assert((size_t)(blockPtr->count + nextBlockPtr->count) <= UnrolledBlockCapacity);
+
+    memcpy(blockPtr->values + blockPtr->count, nextBlockPtr->values,
+           (size_t)nextBlockPtr->count * sizeof(*blockPtr->values));
+
+    blockPtr->count += nextBlockPtr->count;
+
+    UnlinkBlock(list, nextBlock);
+}
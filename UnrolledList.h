@@ -0,0 +1,82 @@
+#ifndef UNROLLED_LIST_H
+#define UNROLLED_LIST_H
+
+#include <stddef.h>
+
+#include "List.h"
+
+/// \file
+/// \brief Unrolled list: every slot is a cache line keeping several values and one link pair.
+/// \details Sequential iteration touches one cache line per UnrolledBlockCapacity values.
+///          Full blocks are split on insert, sparse neighbour blocks are merged on erase,
+///          so element positions are valid only until the next insert or erase.
+
+static const size_t UnrolledBlockCapacity = 11;
+
+struct alignas(64) UnrolledBlockType
+{
+    size_t prevPos;
+    size_t nextPos;
+
+    int count;
+    int values[UnrolledBlockCapacity];
+};
+
+static_assert(sizeof(UnrolledBlockType) == 64, "Unrolled block has to fill one cache line");
+
+/// \brief Element position - block and index in it. Block 0 is the end sentinel.
+struct UnrolledListPosType
+{
+    size_t block;
+    size_t index;
+};
+
+struct UnrolledListType
+{
+    UnrolledBlockType* data;
+
+    size_t end;
+    size_t freeBlockHead;
+
+    size_t size;        ///< number of values
+    size_t blocksCount; ///< number of used blocks
+    size_t capacity;    ///< number of blocks
+
+    ListAllocatorType allocator;
+};
+
+ListErrors UnrolledListCtor  (UnrolledListType* list, const size_t capacity = 0,
+                              const ListAllocatorType* allocator = nullptr);
+ListErrors UnrolledListDtor  (UnrolledListType* list);
+ListErrors UnrolledListVerify(UnrolledListType* list);
+
+/// @brief Inserts value before anchorPos, anchor in end block means pushing back
+ListErrors UnrolledListInsert(UnrolledListType* list, const UnrolledListPosType anchorPos,
+                              const int value, UnrolledListPosType* insertedValPos);
+
+/// @brief Erases value at pos
+/// @param [out]nextValPos position of value that followed erased one (may be nullptr)
+ListErrors UnrolledListErase (UnrolledListType* list, const UnrolledListPosType pos,
+                              UnrolledListPosType* nextValPos);
+
+ListErrors UnrolledListGetElemValue(UnrolledListType* list, UnrolledListPosType pos,
+                                    int* elemValue);
+ListErrors UnrolledListSetElemValue(UnrolledListType* list, UnrolledListPosType pos,
+                                    int  newElemValue);
+
+UnrolledListPosType UnrolledListGetHead    (const UnrolledListType* list);
+UnrolledListPosType UnrolledListGetTail    (const UnrolledListType* list);
+UnrolledListPosType UnrolledListGetEnd     (const UnrolledListType* list);
+UnrolledListPosType UnrolledListGetNextElem(const UnrolledListType* list,
+                                            const UnrolledListPosType pos);
+UnrolledListPosType UnrolledListGetPrevElem(const UnrolledListType* list,
+                                            const UnrolledListPosType pos);
+
+bool UnrolledListPosIsEnd(const UnrolledListType* list, const UnrolledListPosType pos);
+
+#define UNROLLED_LIST_TEXT_DUMP(list) UnrolledListTextDump((list), __FILE__, __func__, __LINE__)
+void UnrolledListTextDump(const UnrolledListType* list, const char* fileName,
+                                                        const char* funcName,
+                                                        const int   line);
+
+#endif
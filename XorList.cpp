@@ -0,0 +1,423 @@
+#include <assert.h>
+#include <string.h>
+
+#include "Log.h"
+#include "Errors.h"
+#include "XorList.h"
+
+static const size_t XorListMinCapacity = 16;
+static const int    POISON             = 0xDEAD;
+
+static inline void FreeSlotsInit(XorListElemType* data, const size_t leftBorder,
+                                                        const size_t rightBorder);
+
+static inline ListErrors SlotsCapacityIncrease(XorListType* list);
+static inline ListErrors GetPosForNewVal      (XorListType* list, size_t* pos);
+static inline void       AddFreeSlot          (XorListType* list, const size_t pos);
+
+static inline void XorErrorPayloadInit(const XorListType* list, ErrorPayloadType* payload);
+static        void XorErrorFormat     (const int code, const ErrorPayloadType* payload);
+
+//dumps are too slow for error bursts, snapshot is logged later by error thread
+#define XOR_LIST_CHECK(list)                                    \
+do                                                              \
+{                                                               \
+    ListErrors listErr = XorListVerify(list);                   \
+                                                                \
+    if (listErr != ListErrors::NO_ERR)                          \
+    {                                                           \
+        ErrorPayloadType errorPayload = {};                     \
+        XorErrorPayloadInit(list, &errorPayload);               \
+        ERROR_RECORD(listErr, &errorPayload, XorErrorFormat);   \
+        return listErr;                                         \
+    }                                                           \
+} while (0)
+
+ListErrors XorListCtor(XorListType* list, const size_t listStandardCapacity,
+                       const ListAllocatorType* allocator)
+{
+    assert(list);
+
+    size_t capacity = listStandardCapacity;
+    if (capacity < XorListMinCapacity)
+        capacity = XorListMinCapacity;
+
+    list->allocator = allocator ? *allocator : ListStandardAllocator();
+
+    list->data = (XorListElemType*) list->allocator.allocFunc(list->allocator.context,
+                                                              capacity * sizeof(*list->data),
+                                                              alignof(XorListElemType));
+
+    if (list->data == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    list->capacity = capacity;
+    list->size     = 0;
+
+    list->data[0].value = POISON;
+    list->data[0].link  = 0;
+
+    FreeSlotsInit(list->data, 1, list->capacity);
+
+    list->end           = 0;
+    list->tail          = 0;
+    list->freeBlockHead = 1;
+
+    XOR_LIST_CHECK(list);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors XorListDtor(XorListType* list)
+{
+    assert(list);
+
+    if (list->data != nullptr)
+        list->allocator.freeFunc(list->allocator.context, list->data,
+                                 list->capacity * sizeof(*list->data));
+
+    list->end = list->tail = list->freeBlockHead = 0;
+    list->capacity = list->size = 0;
+
+    list->data = nullptr;
+    return ListErrors::NO_ERR;
+}
+
+ListErrors XorListVerify(XorListType* list)
+{
+    assert(list);
+
+    if (list->data == nullptr)
+        return ListErrors::DATA_IS_NULLPTR;
+
+    if (list->capacity <= list->size)
+        return ListErrors::OUT_OF_RANGE;
+
+    if (list->freeBlockHead >= list->capacity || list->tail >= list->capacity)
+        return ListErrors::OUT_OF_RANGE;
+
+    if (list->data[list->end].value != POISON)
+        return ListErrors::INVALID_NULLPTR;
+
+    //sentinel link is head ^ tail, both are zero only in empty list
+    const size_t head = list->data[list->end].link ^ list->tail;
+
+    if (head >= list->capacity)
+        return ListErrors::OUT_OF_RANGE;
+
+    if ((list->size == 0) != (head == list->end && list->tail == list->end))
+        return ListErrors::INVALID_DATA;
+
+    if (list->tail != list->end && (list->data[list->tail].link ^ list->end) >= list->capacity)
+        return ListErrors::INVALID_DATA;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors XorListFromList(const ListType* source, XorListType* target,
+                           const ListAllocatorType* allocator)
+{
+    assert(source);
+    assert(target);
+
+    ListErrors error = XorListCtor(target, source->size + 1, allocator);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    //elements take slots 1..size, so neighbours of slot i are i - 1 and i + 1
+    size_t slot = 1;
+    for (size_t pos = source->data[source->end].nextPos; pos != source->end;
+                pos = source->data[pos].nextPos, ++slot)
+    {
+        target->data[slot].value = source->data[pos].value;
+        target->data[slot].link  = (slot - 1) ^ (slot == source->size ? 0 : slot + 1);
+    }
+
+    target->size = source->size;
+    target->tail = source->size;
+
+    target->data[target->end].link = source->size == 0 ? 0 : 1 ^ source->size;
+
+    if (source->size + 1 < target->capacity)
+        FreeSlotsInit(target->data, source->size + 1, target->capacity);
+
+    target->freeBlockHead = source->size + 1 < target->capacity ? source->size + 1 : 0;
+
+    XOR_LIST_CHECK(target);
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors XorListInsert(XorListType* list, const XorListIterType iter, const int value,
+                         XorListIterType* insertedIter)
+{
+    assert(list);
+    assert(iter.prevPos < list->capacity);
+    assert(iter.pos     < list->capacity);
+
+    XOR_LIST_CHECK(list);
+
+    size_t newValPos = 0;
+    ListErrors error = GetPosForNewVal(list, &newValPos);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    list->data[newValPos].value = value;
+    list->data[newValPos].link  = iter.prevPos ^ iter.pos;
+
+    //neighbours swap each other for new element in their links
+    list->data[iter.prevPos].link ^= iter.pos     ^ newValPos;
+    list->data[iter.pos    ].link ^= iter.prevPos ^ newValPos;
+
+    if (iter.pos == list->end)
+        list->tail = newValPos;
+
+    list->size++;
+
+    XOR_LIST_CHECK(list);
+
+    if (insertedIter)
+        *insertedIter = { iter.prevPos, newValPos };
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors XorListErase(XorListType* list, const XorListIterType iter,
+                        XorListIterType* nextIter)
+{
+    assert(list);
+    assert(iter.pos != list->end && iter.pos < list->capacity);
+    assert(iter.prevPos < list->capacity);
+
+    XOR_LIST_CHECK(list);
+
+    const size_t nextPos = list->data[iter.pos].link ^ iter.prevPos;
+
+    list->data[iter.prevPos].link ^= iter.pos ^ nextPos;
+    list->data[nextPos     ].link ^= iter.pos ^ iter.prevPos;
+
+    if (nextPos == list->end)
+        list->tail = iter.prevPos;
+
+    AddFreeSlot(list, iter.pos);
+
+    list->size--;
+
+    XOR_LIST_CHECK(list);
+
+    if (nextIter)
+        *nextIter = { iter.prevPos, nextPos };
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors XorListGetElemValue(XorListType* list, const XorListIterType iter,
+                               int* elemValue)
+{
+    assert(list);
+    assert(elemValue);
+    assert(iter.pos < list->capacity);
+
+    XOR_LIST_CHECK(list);
+
+    if (iter.pos == list->end)
+        return ListErrors::TRYING_TO_GET_NULL_ELEMENT;
+
+    *elemValue = list->data[iter.pos].value;
+
+    return ListErrors::NO_ERR;
+}
+
+ListErrors XorListSetElemValue(XorListType* list, const XorListIterType iter,
+                               int  newElemValue)
+{
+    assert(list);
+    assert(iter.pos < list->capacity);
+
+    XOR_LIST_CHECK(list);
+
+    if (iter.pos == list->end)
+        return ListErrors::TRYING_TO_CHANGE_NULL_ELEMENT;
+
+    list->data[iter.pos].value = newElemValue;
+
+    return ListErrors::NO_ERR;
+}
+
+XorListIterType XorListBegin(const XorListType* list)
+{
+    assert(list);
+
+    return { list->end, list->data[list->end].link ^ list->tail };
+}
+
+XorListIterType XorListEnd(const XorListType* list)
+{
+    assert(list);
+
+    return { list->tail, list->end };
+}
+
+XorListIterType XorListIterNext(const XorListType* list, const XorListIterType iter)
+{
+    assert(list);
+    assert(iter.pos < list->capacity);
+
+    return { iter.pos, list->data[iter.pos].link ^ iter.prevPos };
+}
+
+XorListIterType XorListIterPrev(const XorListType* list, const XorListIterType iter)
+{
+    assert(list);
+    assert(iter.prevPos < list->capacity);
+
+    return { list->data[iter.prevPos].link ^ iter.pos, iter.prevPos };
+}
+
+bool XorListIterIsEnd(const XorListType* list, const XorListIterType iter)
+{
+    assert(list);
+
+    return iter.pos == list->end;
+}
+
+static inline void XorErrorPayloadInit(const XorListType* list, ErrorPayloadType* payload)
+{
+    assert(list);
+    assert(payload);
+
+    //only list fields are copied, slots may be broken
+    payload->words[0] = (uint64_t)list->data;
+    payload->words[1] = list->end;
+    payload->words[2] = list->tail;
+    payload->words[3] = list->freeBlockHead;
+    payload->words[4] = list->size;
+    payload->words[5] = list->capacity;
+}
+
+static void XorErrorFormat(const int code, const ErrorPayloadType* payload)
+{
+    Log("%s", ListErrorsGetMessage((ListErrors)code));
+
+    if (payload == nullptr)
+        return;
+
+    Log("Xor list data: %p, end: %llu, tail: %llu, free slots head: %llu, size: %llu, "
+        "capacity: %llu\n", (void*)payload->words[0],
+        (unsigned long long)payload->words[1], (unsigned long long)payload->words[2],
+        (unsigned long long)payload->words[3], (unsigned long long)payload->words[4],
+        (unsigned long long)payload->words[5]);
+}
+
+void XorListTextDump(const XorListType* list, const char* fileName,
+                                              const char* funcName,
+                                              const int   line)
+{
+    assert(list);
+    assert(fileName);
+    assert(funcName);
+
+    LogBegin(fileName, funcName, line);
+
+    Log("Free blocks head: %zu\n", list->freeBlockHead);
+    Log("Tail            : %zu\n", list->tail);
+
+    Log("List capacity: %zu\n", list->capacity);
+    Log("List size    : %zu\n", list->size);
+
+    Log("Data[%p]:\n", list->data);
+
+    if (list->data == nullptr)
+    {
+        LOG_END();
+        return;
+    }
+
+    Log("List:\n");
+
+    //dump is called on broken lists too, so walk is bounded by capacity
+    XorListIterType iter = XorListBegin(list);
+
+    for (size_t i = 0; i < list->capacity && iter.pos != list->end &&
+                                             iter.pos <  list->capacity; ++i)
+    {
+        Log("\tElement id: %zu, value: %d, link: %zu, previous position: %zu\n",
+            iter.pos, list->data[iter.pos].value, list->data[iter.pos].link, iter.prevPos);
+
+        iter = XorListIterNext(list, iter);
+    }
+
+    LOG_END();
+}
+
+static inline void FreeSlotsInit(XorListElemType* data, const size_t leftBorder,
+                                                        const size_t rightBorder)
+{
+    assert(data);
+    assert(leftBorder != 0);
+    assert(leftBorder < rightBorder);
+
+    for (size_t i = leftBorder; i < rightBorder; ++i)
+    {
+        data[i].value = POISON;
+        data[i].link  = i + 1;
+    }
+
+    data[rightBorder - 1].link = 0;
+}
+
+static inline ListErrors SlotsCapacityIncrease(XorListType* list)
+{
+    assert(list);
+    assert(list->freeBlockHead == 0);
+
+    const size_t newCapacity = list->capacity * 2;
+
+    void* tmpPtr = list->allocator.reallocFunc(list->allocator.context, list->data,
+                                               list->capacity * sizeof(*list->data),
+                                               newCapacity    * sizeof(*list->data),
+                                               alignof(XorListElemType));
+
+    if (tmpPtr == nullptr)
+        return ListErrors::MEMORY_ERR;
+
+    list->data = (XorListElemType*)tmpPtr;
+
+    FreeSlotsInit(list->data, list->capacity, newCapacity);
+
+    list->freeBlockHead = list->capacity;
+    list->capacity      = newCapacity;
+
+    return ListErrors::NO_ERR;
+}
+
+static inline ListErrors GetPosForNewVal(XorListType* list, size_t* pos)
+{
+    assert(list);
+    assert(pos);
+
+    ListErrors error = ListErrors::NO_ERR;
+    if (list->freeBlockHead == 0)
+        error = SlotsCapacityIncrease(list);
+
+    if (error != ListErrors::NO_ERR)
+        return error;
+
+    *pos = list->freeBlockHead;
+    list->freeBlockHead = list->data[list->freeBlockHead].link;
+
+    return ListErrors::NO_ERR;
+}
+
+static inline void AddFreeSlot(XorListType* list, const size_t pos)
+{
+    assert(list);
+    assert(pos != 0 && pos < list->capacity);
+
+    list->data[pos].value = POISON;
+    list->data[pos].link  = list->freeBlockHead;
+
+    list->freeBlockHead = pos;
+}
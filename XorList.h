@@ -0,0 +1,83 @@
+#ifndef XOR_LIST_H
+#define XOR_LIST_H
+
+#include <stddef.h>
+
+#include "List.h"
+
+/// \file
+/// \brief XOR linked list: every slot keeps prevPos ^ nextPos in one link field.
+/// \details Node is 16 bytes instead of 24 of ListElemType, so read mostly lists touch
+///          a third less memory. Neighbour is known only together with the other one,
+///          so lists are walked by iterators carrying position of previous element.
+///          Slot 0 is the end sentinel, its link is head ^ tail, list keeps tail to
+///          start walking from either side. Free slots are chained through link.
+
+struct XorListElemType
+{
+    int value;
+
+    size_t link; ///< prevPos ^ nextPos, next free slot for free slots
+};
+
+/// \brief Pair of neighbour positions, prevPos precedes pos in list order.
+///        Iterator with pos == end is the end one, prevPos of it is tail.
+struct XorListIterType
+{
+    size_t prevPos;
+    size_t pos;
+};
+
+struct XorListType
+{
+    XorListElemType* data;
+
+    size_t end;
+    size_t tail;
+    size_t freeBlockHead;
+
+    size_t size;
+    size_t capacity;
+
+    ListAllocatorType allocator;
+};
+
+ListErrors XorListCtor  (XorListType* list, const size_t capacity = 0,
+                         const ListAllocatorType* allocator = nullptr);
+ListErrors XorListDtor  (XorListType* list);
+ListErrors XorListVerify(XorListType* list);
+
+/// @brief Builds XOR list of values of source, elements are laid out in list order
+ListErrors XorListFromList(const ListType* source, XorListType* target,
+                           const ListAllocatorType* allocator = nullptr);
+
+/// @brief Inserts value between iter.prevPos and iter.pos
+/// @param [out]insertedIter iterator of new element (may be nullptr)
+ListErrors XorListInsert(XorListType* list, const XorListIterType iter, const int value,
+                         XorListIterType* insertedIter);
+
+/// @brief Erases element iter.pos
+/// @param [out]nextIter iterator of element that followed erased one (may be nullptr)
+ListErrors XorListErase (XorListType* list, const XorListIterType iter,
+                         XorListIterType* nextIter);
+
+ListErrors XorListGetElemValue(XorListType* list, const XorListIterType iter,
+                               int* elemValue);
+ListErrors XorListSetElemValue(XorListType* list, const XorListIterType iter,
+                               int  newElemValue);
+
+/// @brief Iterator of head, equal to end iterator if list is empty
+XorListIterType XorListBegin(const XorListType* list);
+XorListIterType XorListEnd  (const XorListType* list);
+
+XorListIterType XorListIterNext(const XorListType* list, const XorListIterType iter);
+XorListIterType XorListIterPrev(const XorListType* list, const XorListIterType iter);
+
+bool XorListIterIsEnd(const XorListType* list, const XorListIterType iter);
+
+#define XOR_LIST_TEXT_DUMP(list) XorListTextDump((list), __FILE__, __func__, __LINE__)
+void XorListTextDump(const XorListType* list, const char* fileName,
+                                              const char* funcName,
+                                              const int   line);
+
+#endif